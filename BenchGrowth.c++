@@ -0,0 +1,103 @@
+// ---------------
+// BenchGrowth.c++
+// ---------------
+
+/*
+To run the benchmark:
+	% g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchGrowth.c++ -o BenchGrowth.c++.app
+	% BenchGrowth.c++.app
+*/
+
+// --------
+// includes
+#include <cstdio>     // printf
+#include <deque>      // deque
+#include <time.h>     // clock_gettime, CLOCK_MONOTONIC
+
+#include "Deque.h"
+#include "IncrementalDeque.h"
+
+// ---------
+// histogram
+/**
+ * Counts latencies in power-of-two buckets of nanoseconds
+ */
+struct histogram {
+	enum {buckets = 40};
+
+	long count[buckets];
+	long total;
+	long max;
+
+	histogram () :
+			total(0), max(0) {
+		for (int i = 0; i != buckets; ++i)
+			count[i] = 0;}
+
+	void add (long ns) {
+		int b = 0;
+		while (b + 1 != buckets && (1L << b) <= ns)
+			++b;
+		++count[b];
+		++total;
+		if (ns > max)
+			max = ns;}
+
+	/**
+	 * Returns the upper edge of the bucket holding the pth percentile
+	 */
+	long percentile (double p) const {
+		long n = 0;
+		for (int b = 0; b != buckets; ++b) {
+			n += count[b];
+			if (n >= p / 100 * total)
+				return 1L << b;}
+		return max;}};
+
+// ---
+// now
+long now () {
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1000000000L + t.tv_nsec;}
+
+// ----
+// fill
+/**
+ * Times each of n push_backs followed by n FIFO rounds of push_back + pop_front
+ */
+template <typename C>
+histogram fill (long n) {
+	histogram h;
+	C x;
+	for (long i = 0; i != n; ++i) {
+		const long t = now();
+		x.push_back(i);
+		h.add(now() - t);}
+	for (long i = 0; i != n; ++i) {
+		const long t = now();
+		x.push_back(i);
+		x.pop_front();
+		h.add(now() - t);}
+	return h;}
+
+// ----
+// main
+int main () {
+	const long n = 1L << 24;
+	const histogram a = fill< MyDeque<int> >(n);
+	const histogram b = fill< MyIncrementalDeque<int> >(n);
+	const histogram c = fill< std::deque<int> >(n);
+
+	std::printf("%d push_backs, then %d push_back + pop_front rounds\n\n", (int)n, (int)n);
+	std::printf("%16s %14s %14s %14s\n", "latency (ns)", "MyDeque", "Incremental", "std::deque");
+	for (int i = 0; i != histogram::buckets; ++i)
+		if (a.count[i] || b.count[i] || c.count[i])
+			std::printf("%7ld-%-8ld %14ld %14ld %14ld\n",
+				i ? 1L << (i - 1) : 0L, (1L << i) - 1, a.count[i], b.count[i], c.count[i]);
+	std::printf("\n");
+	const double p[] = {50, 99, 99.9, 99.99};
+	for (int i = 0; i != 4; ++i)
+		std::printf("p%-15g %14ld %14ld %14ld\n", p[i], a.percentile(p[i]), b.percentile(p[i]), c.percentile(p[i]));
+	std::printf("%-16s %14ld %14ld %14ld\n", "max", a.max, b.max, c.max);
+	return 0;}
@@ -0,0 +1,187 @@
+// --------------
+// BenchTimer.c++
+// --------------
+
+/*
+To run the benchmark:
+	% g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchTimer.c++ -o BenchTimer.c++.app
+	% BenchTimer.c++.app [timers]
+*/
+
+// --------
+// includes
+#include <algorithm>  // pop_heap, push_heap
+#include <cstdio>     // printf
+#include <cstdlib>    // atol, rand, srand
+#include <vector>     // vector
+#include <time.h>     // clock_gettime, CLOCK_MONOTONIC
+
+#include "Deque.h"
+#include "TimerWheel.h"
+
+typedef unsigned long time_type;
+
+// -------
+// Handles
+/**
+ * The handle bookkeeping both baselines share: a cancelled or fired
+ * timer's generation is bumped, and its entries are skipped when met
+ */
+struct Handles {
+	struct handle {
+		std::size_t index;
+		unsigned long generation;};
+
+	std::vector<unsigned long> generation;
+	std::vector<int> value;
+	std::vector<std::size_t> free;
+
+	handle add (int v) {
+		handle h;
+		if (free.empty()) {
+			h.index = value.size();
+			generation.push_back(0);
+			value.push_back(v);}
+		else {
+			h.index = free.back();
+			free.pop_back();
+			value[h.index] = v;}
+		h.generation = generation[h.index];
+		return h;}
+
+	bool live (std::size_t i, unsigned long g) const {
+		return generation[i] == g;}
+
+	bool cancel (const handle& h) {
+		if (!live(h.index, h.generation))
+			return false;
+		remove(h.index);
+		return true;}
+
+	void remove (std::size_t i) {
+		++generation[i];
+		free.push_back(i);}};
+
+// -----
+// entry
+struct entry {
+	time_type deadline;
+	std::size_t index;
+	unsigned long generation;};
+
+// ------
+// Sorted
+/**
+ * Timers in a MyDeque kept sorted by deadline with insert
+ */
+struct Sorted : Handles {
+	MyDeque<entry> q;
+
+	handle schedule (time_type d, int v) {
+		const handle h = add(v);
+		std::size_t lo = 0;
+		std::size_t hi = q.size();
+		while (lo != hi) {
+			const std::size_t m = lo + (hi - lo) / 2;
+			if (q[m].deadline <= d)
+				lo = m + 1;
+			else
+				hi = m;}
+		const entry e = {d, h.index, h.generation};
+		q.insert(q.begin() + lo, e);
+		return h;}
+
+	std::size_t advance (time_type now, MyDeque<int>& expired) {
+		std::size_t n = 0;
+		while (!q.empty() && q.front().deadline <= now) {
+			const entry e = q.front();
+			q.pop_front();
+			if (live(e.index, e.generation)) {
+				expired.push_back(value[e.index]);
+				remove(e.index);
+				++n;}}
+		return n;}};
+
+// ----
+// Heap
+/**
+ * Timers in a binary heap on deadline
+ */
+struct Heap : Handles {
+	struct later {
+		bool operator () (const entry& x, const entry& y) const {
+			return y.deadline < x.deadline;}};
+
+	std::vector<entry> q;
+
+	handle schedule (time_type d, int v) {
+		const handle h = add(v);
+		const entry e = {d, h.index, h.generation};
+		q.push_back(e);
+		std::push_heap(q.begin(), q.end(), later());
+		return h;}
+
+	std::size_t advance (time_type now, MyDeque<int>& expired) {
+		std::size_t n = 0;
+		while (!q.empty() && q.front().deadline <= now) {
+			const entry e = q.front();
+			std::pop_heap(q.begin(), q.end(), later());
+			q.pop_back();
+			if (live(e.index, e.generation)) {
+				expired.push_back(value[e.index]);
+				remove(e.index);
+				++n;}}
+		return n;}};
+
+// ---
+// now
+long now () {
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1000000000L + t.tv_nsec;}
+
+// ---
+// run
+/**
+ * Schedules n timers over horizon ticks, cancels every other one, and
+ * advances step ticks at a time until all have fired, timing each phase
+ */
+template <typename Q>
+void run (const char* name, long n) {
+	const time_type horizon = 1UL << 22;
+	const time_type step = 16;
+	std::srand(0);
+	Q q;
+	std::vector<typename Q::handle> h;
+	h.reserve(n);
+	MyDeque<int> expired;
+
+	long t = now();
+	for (long i = 0; i != n; ++i)
+		h.push_back(q.schedule(1 + (std::rand() % horizon), i));
+	const long schedule = now() - t;
+
+	t = now();
+	for (long i = 0; i < n; i += 2)
+		q.cancel(h[i]);
+	const long cancel = now() - t;
+
+	t = now();
+	std::size_t fired = 0;
+	for (time_type c = 0; c < horizon + step; c += step)
+		fired += q.advance(c, expired);
+	const long advance = now() - t;
+
+	std::printf("%-12s %9ld %12.1f %12.1f %12.1f %12lu\n", name, n,
+		schedule / 1e6, cancel / 1e6, advance / 1e6, (unsigned long)fired);}
+
+// ----
+// main
+int main (int argc, char* argv[]) {
+	const long n = argc > 1 ? std::atol(argv[1]) : 1000000;
+	std::printf("%-12s %9s %12s %12s %12s %12s\n", "", "timers", "schedule ms", "cancel ms", "advance ms", "fired");
+	run< MyTimerWheel<int> >("MyTimerWheel", n);
+	run<Heap>("heap", n);
+	// insert shifts half the deque on average, so this is quadratic
+	run<Sorted>("sorted", n / 10);
+	return 0;}
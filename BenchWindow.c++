@@ -0,0 +1,84 @@
+// ---------------
+// BenchWindow.c++
+// ---------------
+
+/*
+To run the benchmark:
+	% g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchWindow.c++ -o BenchWindow.c++.app
+	% BenchWindow.c++.app
+*/
+
+// --------
+// includes
+#include <algorithm>  // max_element, min_element
+#include <cstdio>     // printf
+#include <cstdlib>    // rand, srand
+#include <ctime>      // clock, CLOCKS_PER_SEC
+#include <functional> // greater
+
+#include "Deque.h"
+#include "Window.h"
+
+// keeps the optimizer from discarding the loops
+volatile long sink;
+
+// ------
+// window
+/**
+ * Pushes w values, then times t ticks of push + min + max + sum
+ * Returns nanoseconds per tick
+ */
+double window (int w, int t) {
+	MyMonotonicWindow<int> lo(w);
+	MyMonotonicWindow<int, std::greater<int> > hi(w);
+	MyAggregateWindow<long> sum(w);
+	for (int i = 0; i < w; ++i) {
+		const int v = std::rand();
+		lo.push(v);
+		hi.push(v);
+		sum.push(v);}
+	const std::clock_t c = std::clock();
+	for (int i = 0; i < t; ++i) {
+		const int v = std::rand();
+		lo.push(v);
+		hi.push(v);
+		sum.push(v);
+		sink += lo.value() + hi.value() + sum.value();}
+	return 1e9 * (std::clock() - c) / CLOCKS_PER_SEC / t;}
+
+// ------
+// rescan
+/**
+ * Pushes w values, then times t ticks of push + a full rescan for min, max and sum
+ * Returns nanoseconds per tick
+ */
+double rescan (int w, int t) {
+	MyDeque<int> d;
+	for (int i = 0; i < w; ++i)
+		d.push_back(std::rand());
+	const std::clock_t c = std::clock();
+	for (int i = 0; i < t; ++i) {
+		d.pop_front();
+		d.push_back(std::rand());
+		int lo = d[0];
+		int hi = d[0];
+		long sum = 0;
+		for (MyDeque<int>::size_type j = 0; j != d.size(); ++j) {
+			lo = std::min(lo, d[j]);
+			hi = std::max(hi, d[j]);
+			sum += d[j];}
+		sink += lo + hi + sum;}
+	return 1e9 * (std::clock() - c) / CLOCKS_PER_SEC / t;}
+
+// ----
+// main
+int main () {
+	std::srand(0);
+	std::printf("%10s %14s %14s %10s\n", "window", "ns/tick", "rescan ns/tick", "speedup");
+	for (int w = 10; w <= 1000000; w *= 10) {
+		// rescans cost O(w) per tick, so cap their total work near 10^9 reads
+		const int t = std::min(1000000, std::max(100, 1000000000 / w));
+		const double a = window(w, 1000000);
+		const double b = rescan(w, t);
+		std::printf("%10d %14.1f %14.1f %9.1fx\n", w, a, b, b / a);}
+	return 0;}
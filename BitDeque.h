@@ -0,0 +1,869 @@
+// ----------
+// BitDeque.h
+// ----------
+
+#ifndef BitDeque_h
+#define BitDeque_h
+
+// --------
+// includes
+#include <algorithm>	// lexicographical_compare, min, swap
+#include <cassert>		// assert
+#include <climits>		// CHAR_BIT
+#include <cstddef>		// size_t
+#include <iterator>		// bidirectional_iterator_tag, iterator_traits
+#include <limits>		// numeric_limits
+#include <memory>		// allocator, allocator_traits
+#include <stdexcept>	// out_of_range
+
+#if __cplusplus >= 201103L
+#include <initializer_list>	// initializer_list
+#endif
+
+#include "Deque.h"		// integral_tag, MyDeque
+
+// ----------
+// MyBitDeque
+/**
+ * A deque of flags packed 64 to a word
+ * It is its own class rather than a specialization of MyDeque<bool>,
+ * which stays an ordinary MyDeque: packed flags cannot offer data(),
+ * snapshots of their bytes, or references to bool.
+ * The words live in a MyDeque<unsigned long>, flag 0 at bit _head of the
+ * first word and each next flag one bit higher, so pushing or popping a
+ * flag at either end touches one word and adds or drops a word only at a
+ * word boundary. Bits outside the flags are kept 0. count and find_first
+ * take a whole word per step, and the *_word operations move up to 64
+ * flags at a time. operator[] returns a proxy, as std::vector<bool> does.
+ */
+template < typename A = std::allocator<bool> >
+class MyBitDeque {
+	public:
+		// --------
+		// typedefs
+		typedef A						allocator_type;
+		typedef bool						value_type;
+
+		typedef typename allocator_type::size_type		size_type;
+		typedef typename allocator_type::difference_type	difference_type;
+
+		typedef bool						const_reference;
+
+		typedef unsigned long					word;
+
+		enum {bits = sizeof(word) * CHAR_BIT};
+
+	private:
+#if __cplusplus >= 201103L
+		typedef typename std::allocator_traits<A>::template rebind_alloc<word>	word_allocator;
+#else
+		typedef typename A::template rebind<word>::other			word_allocator;
+#endif
+
+	public:
+		// -----------
+		// operator ==
+		/**
+		 * Returns whether both deques hold the same flags, compared a word at a time
+		 */
+		friend bool operator == (const MyBitDeque& lhs, const MyBitDeque& rhs) {
+			if (lhs.size() != rhs.size())
+				return false;
+			for (size_type i = 0; i < lhs.size(); i += bits) {
+				const size_type n = std::min(lhs.size() - i, size_type(bits));
+				if (lhs.read(i, n) != rhs.read(i, n))
+					return false;}
+			return true;}
+
+		// ----------
+		// operator <
+		/**
+		 * Returns whether lhs orders lexicographically before rhs, false before true
+		 */
+		friend bool operator < (const MyBitDeque& lhs, const MyBitDeque& rhs) {
+			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );}
+
+	private:
+		// ----
+		// data
+		MyDeque<word, word_allocator> _words;
+		size_type _head;	// bit of flag 0 in _words.front()
+		size_type _size;	// number of flags
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return (_head < bits) && (_size || !_head) &&
+				(_words.size() == (_head + _size + bits - 1) / bits);}
+
+		// ----
+		// mask
+		/**
+		 * Returns a word with the low n bits set
+		 */
+		static word mask (size_type n) {
+			return n < bits ? (word(1) << n) - 1 : ~word(0);}
+
+		// --------
+		// popcount
+		static size_type popcount (word w) {
+#ifdef __GNUC__
+			return __builtin_popcountl(w);
+#else
+			size_type n = 0;
+			for (; w; w &= w - 1)
+				++n;
+			return n;
+#endif
+			}
+
+		// ---
+		// ctz
+		/**
+		 * Returns the index of the lowest set bit of w, which must not be 0
+		 */
+		static size_type ctz (word w) {
+			assert(w);
+#ifdef __GNUC__
+			return __builtin_ctzl(w);
+#else
+			size_type n = 0;
+			for (; !(w & 1); w >>= 1)
+				++n;
+			return n;
+#endif
+			}
+
+	public:
+		// ---------
+		// reference
+		/**
+		 * A proxy for one flag
+		 */
+		class reference {
+			friend class MyBitDeque;
+
+			private:
+				word* _w;
+				word _m;
+
+				reference (word* w, word m) :
+					_w(w), _m(m) {}
+
+			public:
+				/**
+				 * Returns the flag
+				 */
+				operator bool () const {
+					return *_w & _m;}
+
+				/**
+				 * Sets the flag to v
+				 */
+				reference& operator = (bool v) {
+					if (v)
+						*_w |= _m;
+					else
+						*_w &= ~_m;
+					return *this;}
+
+				/**
+				 * Sets the flag to that flag
+				 */
+				reference& operator = (const reference& that) {
+					return *this = bool(that);}
+
+				/**
+				 * Inverts the flag
+				 */
+				void flip () {
+					*_w ^= _m;}};
+
+		// --------
+		// iterator
+		class iterator {
+			friend class MyBitDeque;
+
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag   	iterator_category;
+				typedef typename MyBitDeque::value_type	  	value_type;
+				typedef typename MyBitDeque::difference_type 	difference_type;
+				typedef void					pointer;
+				typedef typename MyBitDeque::reference	  	reference;
+				typedef typename MyBitDeque::size_type 	  	size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const iterator& lhs, const iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const iterator& lhs, const iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend iterator operator + (iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend iterator operator - (iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+				/**
+				 * Returns the number of elements from rhs to lhs
+				 */
+				friend difference_type operator - (const iterator& lhs, const iterator& rhs) {
+					assert(lhs._d == rhs._d);
+					return lhs.idx - rhs.idx;}
+
+			private:
+				// ----
+				// data
+				MyBitDeque* _d;
+				size_type idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns an iterator to the ith element of d
+				 */
+				iterator (MyBitDeque* d, size_type i = 0) :
+					_d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Returns the actual flag
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				iterator operator ++ (int) {
+					iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				iterator operator -- (int) {
+					iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+	public:
+		// --------------
+		// const_iterator
+		class const_iterator {
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag   iterator_category;
+				typedef typename MyBitDeque::value_type	  value_type;
+				typedef typename MyBitDeque::difference_type difference_type;
+				typedef void				pointer;
+				typedef bool				reference;
+				typedef typename MyBitDeque::size_type 	  size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend const_iterator operator + (const_iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend const_iterator operator - (const_iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+				/**
+				 * Returns the number of elements from rhs to lhs
+				 */
+				friend difference_type operator - (const const_iterator& lhs, const const_iterator& rhs) {
+					assert(lhs._d == rhs._d);
+					return lhs.idx - rhs.idx;}
+
+			private:
+				// ----
+				// data
+				const MyBitDeque*	_d;
+				size_type 		idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns a const_iterator to the ith element of d
+				 */
+				const_iterator (const MyBitDeque* d, size_type i)
+					: _d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Returns the actual flag
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				const_iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				const_iterator operator ++ (int) {
+					const_iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				const_iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				const_iterator operator -- (int) {
+					const_iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				const_iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				const_iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+	public:
+		// ------------
+		// constructors
+		/**
+		 * Returns an empty deque with the specified allocator
+		 */
+		explicit MyBitDeque (const allocator_type& a = allocator_type() )
+			: _words(word_allocator(a)), _head(0), _size(0) {
+			assert(valid() );}
+
+		/**
+		 * Returns a deque of s copies of v, filled a word at a time
+		 */
+		explicit MyBitDeque (size_type s, bool v = false, const allocator_type& a = allocator_type())
+			: _words(word_allocator(a)), _head(0), _size(0) {
+			resize(s, v);
+			assert(valid() );}
+
+		/**
+		 * Returns a deque of the flags in [b, e)
+		 */
+		template <typename II>
+		MyBitDeque (II b, II e, const allocator_type& a = allocator_type())
+			: _words(word_allocator(a)), _head(0), _size(0) {
+			assign(b, e);
+			assert(valid() );}
+
+#if __cplusplus >= 201103L
+		/**
+		 * Returns a deque of the flags in l, so MyBitDeque<> x{true, false}
+		 * has two flags, as a MyDeque would
+		 */
+		MyBitDeque (std::initializer_list<bool> l, const allocator_type& a = allocator_type())
+			: _words(word_allocator(a)), _head(0), _size(0) {
+			assign(l.begin(), l.end());
+			assert(valid() );}
+#endif
+
+		// Default copy, destructor, and copy assignment.
+		// MyBitDeque (const MyBitDeque&);
+		// ~MyBitDeque ();
+		// MyBitDeque& operator = (const MyBitDeque&);
+
+#if __cplusplus >= 201103L
+		// ----------
+		// operator =
+		/**
+		 * Returns a reference of this deque after replacing its flags with l's
+		 */
+		MyBitDeque& operator = (std::initializer_list<bool> l) {
+			assign(l);
+			return *this;}
+#endif
+
+		// -----------
+		// operator []
+		/**
+		 * Returns a proxy for the nth flag
+		 */
+		reference operator [] (size_type n) {
+			assert(n < size() );
+			const size_type p = _head + n;
+			return reference(&_words[p / bits], word(1) << (p % bits) );}
+
+		/**
+		 * Returns the nth flag
+		 */
+		const_reference operator [] (size_type n) const {
+			assert(n < size() );
+			const size_type p = _head + n;
+			return (_words[p / bits] >> (p % bits)) & 1;}
+
+		// --
+		// at
+		/**
+		 * Returns a proxy for the nth flag
+		 * Throws an exception if n is out of bounds
+		 */
+		reference at (size_type n) {
+			if (n >= size() )
+				throw std::out_of_range("deque::_M_range_check");
+			return (*this)[n];}
+
+		/**
+		 * Returns the nth flag
+		 * Throws an exception if n is out of bounds
+		 */
+		const_reference at (size_type n) const {
+			if (n >= size() )
+				throw std::out_of_range("deque::_M_range_check");
+			return (*this)[n];}
+
+		// ------
+		// assign
+		/**
+		 * Replaces the flags with s copies of v
+		 */
+		void assign (size_type s, bool v) {
+			clear();
+			resize(s, v);}
+
+		/**
+		 * Replaces the flags with those in [b, e), which must not point into
+		 * this deque
+		 */
+		template <typename II>
+		void assign (II b, II e) {
+			assign(b, e, integral_tag<std::numeric_limits<II>::is_integer>());
+			assert(valid() );}
+
+#if __cplusplus >= 201103L
+		/**
+		 * Replaces the flags with l's
+		 */
+		void assign (std::initializer_list<bool> l) {
+			assign(l.begin(), l.end());}
+#endif
+
+		// ----
+		// back
+		/**
+		 * Returns a proxy for the last flag
+		 */
+		reference back () {
+			assert(!empty() );
+			return (*this)[size() - 1];}
+
+		/**
+		 * Returns the last flag
+		 */
+		const_reference back () const {
+			assert(!empty() );
+			return (*this)[size() - 1];}
+
+		// -----
+		// begin
+		/**
+		 * Returns an iterator for the first flag
+		 */
+		iterator begin () {
+			return iterator(this, 0);}
+
+		/**
+		 * Returns a constant iterator for the first flag
+		 */
+		const_iterator begin () const {
+			return const_iterator(this, 0);}
+
+		// -----
+		// clear
+		/**
+		 * Removes all flags
+		 */
+		void clear () {
+			_words.clear();
+			_head = _size = 0;
+			assert(valid() );}
+
+		// -----
+		// count
+		/**
+		 * Returns the number of set flags
+		 */
+		size_type count () const {
+			return count(0, size() );}
+
+		/**
+		 * Returns the number of set flags in [b, e), a word at a time
+		 */
+		size_type count (size_type b, size_type e) const {
+			assert(b <= e && e <= size() );
+			size_type n = 0;
+			while (b < e) {
+				const size_type k = std::min(e - b, bits - (_head + b) % bits);
+				n += popcount(read(b, k) );
+				b += k;}
+			return n;}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the container is empty
+		 */
+		bool empty () const {
+			return !size();}
+
+		// ---
+		// end
+		/**
+		 * Returns an iterator to the position after the last flag
+		 */
+		iterator end () {
+			return iterator(this, size() );}
+
+		/**
+		 * Returns a constant iterator to the position after the last flag
+		 */
+		const_iterator end () const {
+			return const_iterator(this, size() );}
+
+		// -----
+		// erase
+		/**
+		 * Removes the flag at iterator position pos and returns the position of the next flag
+		 * Shifts the flags after pos down one at a time
+		 */
+		iterator erase (iterator pos) {
+			assert(pos.idx < size() );
+			for (size_type i = pos.idx; i + 1 < size(); ++i)
+				(*this)[i] = (*this)[i + 1];
+			pop_back();
+			return pos;}
+
+		// ----------
+		// find_first
+		/**
+		 * Returns the index of the first set flag, or size() if there is none
+		 */
+		size_type find_first () const {
+			return find_first(0, size() );}
+
+		/**
+		 * Returns the index of the first set flag in [b, e), or e if there is none
+		 * Skips a word of clear flags per step
+		 */
+		size_type find_first (size_type b, size_type e) const {
+			assert(b <= e && e <= size() );
+			while (b < e) {
+				const size_type k = std::min(e - b, bits - (_head + b) % bits);
+				const word w = read(b, k);
+				if (w)
+					return b + ctz(w);
+				b += k;}
+			return e;}
+
+		// -----
+		// front
+		/**
+		 * Returns a proxy for the first flag
+		 */
+		reference front () {
+			assert(!empty() );
+			return (*this)[0];}
+
+		/**
+		 * Returns the first flag
+		 */
+		const_reference front () const {
+			assert(!empty() );
+			return (*this)[0];}
+
+		// ------
+		// insert
+		/**
+		 * Inserts v before iterator position pos and returns the position of the new flag
+		 * Shifts the flags from pos up one at a time
+		 */
+		iterator insert (iterator pos, bool v) {
+			assert(pos.idx <= size() );
+			push_back(false);
+			for (size_type i = size() - 1; i > pos.idx; --i)
+				(*this)[i] = (*this)[i - 1];
+			(*this)[pos.idx] = v;
+			return pos;}
+
+		// --------
+		// pop_back
+		/**
+		 * Removes the last flag
+		 */
+		void pop_back () {
+			pop_back(1);}
+
+		/**
+		 * Removes the last n flags, dropping whole words at a time
+		 */
+		void pop_back (size_type n) {
+			assert(n <= size() );
+			_size -= n;
+			if (!_size)
+				clear();
+			else {
+				const size_type w = (_head + _size + bits - 1) / bits;
+				while (_words.size() > w)
+					_words.pop_back();
+				_words.back() &= mask((_head + _size - 1) % bits + 1);}
+			assert(valid() );}
+
+		// ---------
+		// pop_front
+		/**
+		 * Removes the first flag
+		 */
+		void pop_front () {
+			pop_front(1);}
+
+		/**
+		 * Removes the first n flags, dropping whole words at a time
+		 */
+		void pop_front (size_type n) {
+			assert(n <= size() );
+			_size -= n;
+			if (!_size)
+				clear();
+			else {
+				_head += n;
+				for (; _head >= bits; _head -= bits)
+					_words.pop_front();
+				_words.front() &= ~mask(_head);}
+			assert(valid() );}
+
+		// ---------
+		// push_back
+		/**
+		 * Appends v
+		 */
+		void push_back (bool v) {
+			push_back_word(v, 1);}
+
+		// --------------
+		// push_back_word
+		/**
+		 * Appends the low n bits of w, bit 0 first
+		 * Costs at most one new word
+		 */
+		void push_back_word (word w, size_type n = bits) {
+			assert(n <= bits);
+			if (!n)
+				return;
+			w &= mask(n);
+			const size_type p = (_head + _size) % bits;
+			if (!p)
+				_words.push_back(w);
+			else {
+				_words.back() |= w << p;
+				if (n > bits - p)
+					_words.push_back(w >> (bits - p) );}
+			_size += n;
+			assert(valid() );}
+
+		// ----------
+		// push_front
+		/**
+		 * Prepends v
+		 */
+		void push_front (bool v) {
+			push_front_word(v, 1);}
+
+		// ---------------
+		// push_front_word
+		/**
+		 * Prepends the low n bits of w, so that bit 0 of w becomes the first flag
+		 * Costs at most one new word
+		 */
+		void push_front_word (word w, size_type n = bits) {
+			assert(n <= bits);
+			if (!n)
+				return;
+			w &= mask(n);
+			if (_head >= n) {
+				_words.front() |= w << (_head - n);
+				_head -= n;}
+			else {
+				if (_head)
+					_words.front() |= w >> (n - _head);
+				_words.push_front(w << (bits - (n - _head)) );
+				_head = bits - (n - _head);}
+			_size += n;
+			assert(valid() );}
+
+		// ----
+		// read
+		/**
+		 * Returns n <= 64 flags from index i as the low bits of a word, flag i at bit 0
+		 */
+		word read (size_type i, size_type n = bits) const {
+			assert(n <= bits && i + n <= size() );
+			if (!n)
+				return 0;
+			const size_type p = _head + i;
+			const size_type o = p % bits;
+			word w = _words[p / bits] >> o;
+			if (o + n > bits)
+				w |= _words[p / bits + 1] << (bits - o);
+			return w & mask(n);}
+
+		// ------
+		// resize
+		/**
+		 * Changes the number of flags to s (if size() grows new flags are v)
+		 * Works a word at a time
+		 */
+		void resize (size_type s, bool v = false) {
+			if (s < size() )
+				pop_back(size() - s);
+			while (size() < s)
+				push_back_word(v ? ~word(0) : 0, std::min(s - size(), size_type(bits)) );
+			assert(valid() );}
+
+		// ----
+		// size
+		/**
+		 * Returns the current number of flags
+		 */
+		size_type size () const {
+			return _size;}
+
+		// ----
+		// swap
+		/**
+		 * Swaps the data of this with the data of that
+		 */
+		void swap (MyBitDeque& that) {
+			_words.swap(that._words);
+			std::swap(_head, that._head);
+			std::swap(_size, that._size);
+			assert(valid() );}
+
+	private:
+		// ------
+		// assign
+		template <typename I>
+		void assign (I s, I v, integral_tag<true>) {
+			assign(size_type(s), bool(v));}
+
+		template <typename II>
+		void assign (II b, II e, integral_tag<false>) {
+			clear();
+			for (; b != e; ++b)
+				push_back(*b);}};
+
+#endif // BitDeque_h
@@ -0,0 +1,393 @@
+// ---------
+// Channel.h
+// ---------
+
+#ifndef Channel_h
+#define Channel_h
+
+#if __cplusplus <= 201703L
+#error "Channel.h needs C++20 coroutines (-std=c++20)"
+#endif
+
+// --------
+// includes
+#include <cassert>		// assert
+#include <coroutine>	// coroutine_handle, suspend_always, suspend_never
+#include <cstddef>		// size_t
+#include <exception>	// terminate
+#include <optional>		// optional
+#include <utility>		// exchange
+
+#include "Deque.h"		// MyDeque
+
+// ------
+// MyTask
+/**
+ * A fire-and-forget coroutine that starts suspended until it is spawned
+ * on a MyExecutor; its frame frees itself when the body returns
+ */
+class MyTask {
+	public:
+		// ------------
+		// promise_type
+		struct promise_type {
+			MyTask get_return_object () {
+				return MyTask(std::coroutine_handle<promise_type>::from_promise(*this));}
+
+			std::suspend_always initial_suspend () noexcept {
+				return {};}
+
+			std::suspend_never final_suspend () noexcept {
+				return {};}
+
+			void return_void () {}
+
+			void unhandled_exception () {
+				std::terminate();}};
+
+	private:
+		// ----
+		// data
+		std::coroutine_handle<promise_type> _h;
+
+	private:
+		explicit MyTask (std::coroutine_handle<promise_type> h) :
+			_h(h) {}
+
+	public:
+		MyTask (MyTask&& that) :
+			_h(std::exchange(that._h, nullptr)) {}
+
+		MyTask (const MyTask&) = delete;
+		MyTask& operator = (const MyTask&) = delete;
+
+		// ----------
+		// destructor
+		/**
+		 * Frees a task that was never spawned
+		 */
+		~MyTask () {
+			if (_h)
+				_h.destroy();}
+
+		// -------
+		// release
+		/**
+		 * Hands the suspended coroutine over to the caller
+		 */
+		std::coroutine_handle<> release () {
+			return std::exchange(_h, nullptr);}};
+
+// ----------
+// MyExecutor
+/**
+ * A single-threaded run queue of coroutines ready to resume
+ * Channels post woken waiters here instead of resuming them inline, so
+ * one thread drives any number of producers and consumers without a
+ * handoff and without the stack growing with each wakeup.
+ */
+class MyExecutor {
+	private:
+		// ----
+		// data
+		MyDeque< std::coroutine_handle<> > _ready;
+
+	public:
+		// -----
+		// empty
+		/**
+		 * Returns whether no coroutine is ready to run
+		 */
+		bool empty () const {
+			return _ready.empty();}
+
+		// ----
+		// post
+		/**
+		 * Queues h to be resumed by run()
+		 */
+		void post (std::coroutine_handle<> h) {
+			_ready.push_back(h);}
+
+		// ---
+		// run
+		/**
+		 * Resumes ready coroutines until none are left
+		 * Returns how many resumptions ran
+		 */
+		std::size_t run () {
+			std::size_t n = 0;
+			while (!_ready.empty()) {
+				std::coroutine_handle<> h = _ready.front();
+				_ready.pop_front();
+				h.resume();
+				++n;}
+			return n;}
+
+		// -----
+		// spawn
+		/**
+		 * Queues a new task to start on the next run()
+		 */
+		void spawn (MyTask t) {
+			post(t.release());}};
+
+// ---------
+// MyChannel
+/**
+ * A coroutine queue on MyDeque storage
+ * co_await pop() yields the next value, or an empty optional once the
+ * channel is closed and drained. co_await push(v) suspends while a
+ * bounded channel is full and yields false if the channel is closed.
+ * A value pushed while a receiver waits goes straight to that receiver,
+ * which is then posted to the executor.
+ */
+template <typename T>
+class MyChannel {
+	public:
+		// --------
+		// typedefs
+		typedef T			value_type;
+		typedef std::size_t	size_type;
+
+	private:
+		// ------
+		// waiter
+		struct waiter {
+			std::coroutine_handle<>	handle;
+			std::optional<T>		value;		// received value, or the value a sender is waiting to send
+			MyDeque<T>*				batch;		// batch receivers take their value here instead
+			bool					ok;			// whether a waiting sender's value was taken
+
+			waiter () :
+				batch(0), ok(false) {}};
+
+	private:
+		// ----
+		// data
+		MyExecutor& _ex;
+		MyDeque<T> _buffer;
+		MyDeque<waiter*> _receivers;	// waiting for a value, only while _buffer is empty
+		MyDeque<waiter*> _senders;		// waiting for room, only while _buffer is full
+		size_type _capacity;			// 0 for unbounded
+		bool _closed;
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return (_receivers.empty() || _buffer.empty()) &&
+				(_senders.empty() || (_capacity && _buffer.size() == _capacity));}
+
+	public:
+		// ------------
+		// pop_awaiter
+		class pop_awaiter {
+			friend class MyChannel;
+
+			private:
+				MyChannel& _c;
+				waiter _w;
+
+				explicit pop_awaiter (MyChannel& c) :
+					_c(c) {}
+
+			public:
+				bool await_ready () {
+					return _c.receive(_w, 1);}
+
+				void await_suspend (std::coroutine_handle<> h) {
+					_w.handle = h;
+					_c._receivers.push_back(&_w);}
+
+				std::optional<T> await_resume () {
+					return std::move(_w.value);}};
+
+		// ------------------
+		// pop_batch_awaiter
+		class pop_batch_awaiter {
+			friend class MyChannel;
+
+			private:
+				MyChannel& _c;
+				waiter _w;
+				size_type _n;
+				size_type _before;
+
+				pop_batch_awaiter (MyChannel& c, MyDeque<T>& out, size_type n) :
+					_c(c), _n(n), _before(out.size()) {
+					_w.batch = &out;}
+
+			public:
+				bool await_ready () {
+					return _c.receive(_w, _n);}
+
+				void await_suspend (std::coroutine_handle<> h) {
+					_w.handle = h;
+					_c._receivers.push_back(&_w);}
+
+				size_type await_resume () {
+					return _w.batch->size() - _before;}};
+
+		// -------------
+		// push_awaiter
+		class push_awaiter {
+			friend class MyChannel;
+
+			private:
+				MyChannel& _c;
+				waiter _w;
+
+				push_awaiter (MyChannel& c, const T& v) :
+					_c(c) {
+					_w.value = v;}
+
+			public:
+				bool await_ready () {
+					if (_c._closed)
+						return true;
+					_w.ok = _c.try_push(*_w.value);
+					return _w.ok;}
+
+				void await_suspend (std::coroutine_handle<> h) {
+					_w.handle = h;
+					_c._senders.push_back(&_w);}
+
+				bool await_resume () {
+					return _w.ok;}};
+
+	public:
+		// -----------
+		// constructor
+		/**
+		 * Returns an open channel that wakes waiters on ex and holds at most
+		 * capacity buffered values (0 for unbounded)
+		 */
+		explicit MyChannel (MyExecutor& ex, size_type capacity = 0) :
+			_ex(ex), _capacity(capacity), _closed(false) {
+			assert(valid());}
+
+		MyChannel (const MyChannel&) = delete;
+		MyChannel& operator = (const MyChannel&) = delete;
+
+		// -----
+		// close
+		/**
+		 * Closes the channel: waiting senders resume with false, waiting
+		 * receivers with nothing; buffered values can still be popped
+		 */
+		void close () {
+			_closed = true;
+			while (!_receivers.empty()) {
+				_ex.post(_receivers.front()->handle);
+				_receivers.pop_front();}
+			while (!_senders.empty()) {
+				_ex.post(_senders.front()->handle);
+				_senders.pop_front();}
+			assert(valid());}
+
+		// ------
+		// closed
+		/**
+		 * Returns whether close() has been called
+		 */
+		bool closed () const {
+			return _closed;}
+
+		// ---
+		// pop
+		/**
+		 * Returns an awaitable for the next value
+		 */
+		pop_awaiter pop () {
+			return pop_awaiter(*this);}
+
+		// ---------
+		// pop_batch
+		/**
+		 * Returns an awaitable that appends between 1 and n values to out,
+		 * suspending only while nothing is available, and yields the count
+		 * (0 once the channel is closed and drained)
+		 */
+		pop_batch_awaiter pop_batch (MyDeque<T>& out, size_type n) {
+			assert(n > 0);
+			return pop_batch_awaiter(*this, out, n);}
+
+		// ----
+		// push
+		/**
+		 * Returns an awaitable that sends v
+		 */
+		push_awaiter push (const T& v) {
+			return push_awaiter(*this, v);}
+
+		// ----
+		// size
+		/**
+		 * Returns the number of buffered values
+		 */
+		size_type size () const {
+			return _buffer.size();}
+
+		// -------
+		// try_pop
+		/**
+		 * Returns the next buffered value without suspending, if there is one
+		 */
+		std::optional<T> try_pop () {
+			waiter w;
+			if (_buffer.empty() || !receive(w, 1))
+				return std::nullopt;
+			return std::move(w.value);}
+
+		// --------
+		// try_push
+		/**
+		 * Sends v without suspending
+		 * Returns false if the channel is closed or full
+		 */
+		bool try_push (const T& v) {
+			if (_closed)
+				return false;
+			if (!_receivers.empty()) {
+				waiter* w = _receivers.front();
+				_receivers.pop_front();
+				if (w->batch)
+					w->batch->push_back(v);
+				else
+					w->value = v;
+				_ex.post(w->handle);}
+			else if (!_capacity || _buffer.size() < _capacity)
+				_buffer.push_back(v);
+			else
+				return false;
+			assert(valid());
+			return true;}
+
+	private:
+		// -------
+		// receive
+		/**
+		 * Takes up to n buffered values into w, refilling from waiting senders
+		 * Returns false if w has to wait
+		 */
+		bool receive (waiter& w, size_type n) {
+			if (_buffer.empty())
+				return _closed;
+			if (w.batch)
+				for (; n && !_buffer.empty(); --n) {
+					w.batch->push_back(_buffer.front());
+					_buffer.pop_front();}
+			else {
+				w.value = _buffer.front();
+				_buffer.pop_front();}
+			while (!_senders.empty() && _buffer.size() < _capacity) {
+				waiter* s = _senders.front();
+				_senders.pop_front();
+				_buffer.push_back(*s->value);
+				s->ok = true;
+				_ex.post(s->handle);}
+			assert(valid());
+			return true;}};
+
+#endif // Channel_h
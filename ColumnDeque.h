@@ -0,0 +1,717 @@
+// -------------
+// ColumnDeque.h
+// -------------
+
+#ifndef ColumnDeque_h
+#define ColumnDeque_h
+
+#if __cplusplus < 201703L
+#error "ColumnDeque.h needs C++17 (-std=c++17)"
+#endif
+
+// --------
+// includes
+#include <algorithm>	// lexicographical_compare
+#include <cassert>		// assert
+#include <cstddef>		// ptrdiff_t, size_t
+#include <iterator>		// bidirectional_iterator_tag
+#include <stdexcept>	// out_of_range
+#include <tuple>		// get, tuple, tuple_element, tuple_size
+#include <utility>		// index_sequence, make_index_sequence, swap
+
+#include "Deque.h"		// MyDeque
+
+// ------
+// MySpan
+/**
+ * A pointer and a length over contiguous elements
+ */
+template <typename T>
+class MySpan {
+	public:
+		// --------
+		// typedefs
+		typedef T				value_type;
+		typedef T*				iterator;
+		typedef std::size_t		size_type;
+
+	private:
+		// ----
+		// data
+		T* _p;
+		size_type _n;
+
+	public:
+		// -----------
+		// constructor
+		/**
+		 * Returns a span over [p, p + n)
+		 */
+		MySpan (T* p, size_type n) :
+			_p(p), _n(n) {}
+
+		// -----------
+		// operator []
+		/**
+		 * Returns a reference to the ith element
+		 */
+		T& operator [] (size_type i) const {
+			assert(i < _n);
+			return _p[i];}
+
+		// -----
+		// begin
+		/**
+		 * Returns a pointer to the first element
+		 */
+		iterator begin () const {
+			return _p;}
+
+		// ----
+		// data
+		/**
+		 * Returns a pointer to the first element
+		 */
+		T* data () const {
+			return _p;}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the span is empty
+		 */
+		bool empty () const {
+			return !_n;}
+
+		// ---
+		// end
+		/**
+		 * Returns a pointer to the position after the last element
+		 */
+		iterator end () const {
+			return _p + _n;}
+
+		// ----
+		// size
+		/**
+		 * Returns the number of elements
+		 */
+		size_type size () const {
+			return _n;}};
+
+// -----
+// field
+/**
+ * Returns the Jth field of a tuple-like record, found the way structured
+ * bindings find it
+ */
+template <std::size_t J, typename R>
+decltype(auto) field (R&& r) {
+	using std::get;
+	return get<J>(std::forward<R>(r));}
+
+// -------------
+// MyColumnDeque
+/**
+ * A deque of records stored one column per field
+ * R is any tuple-like type (std::tuple, std::pair, std::array, or a type
+ * with tuple_size, tuple_element, and get); field J of every record lives
+ * in its own MyDeque, so a scan of one field only touches that field's
+ * memory, and column<J>() hands the field out as one contiguous span.
+ * operator[] returns a proxy that reads or writes a whole record;
+ * get<J>(i) reaches a single field without assembling the record.
+ */
+template < typename R, typename = std::make_index_sequence<std::tuple_size<R>::value> >
+class MyColumnDeque;
+
+template <typename R, std::size_t... I>
+class MyColumnDeque< R, std::index_sequence<I...> > {
+	static_assert(sizeof...(I) > 0, "MyColumnDeque needs a record with at least one field");
+
+	public:
+		// --------
+		// typedefs
+		typedef R				value_type;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+
+		template <std::size_t J>
+		using column_type = typename std::tuple_element<J, R>::type;
+
+	private:
+		// ----
+		// data
+		std::tuple< MyDeque< column_type<I> >... > _columns;
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return ((std::get<I>(_columns).size() == size()) && ...);}
+
+	public:
+		// ---------
+		// reference
+		/**
+		 * A proxy for the record at one index
+		 */
+		class reference {
+			friend class MyColumnDeque;
+
+			private:
+				MyColumnDeque* _d;
+				size_type _i;
+
+				reference (MyColumnDeque* d, size_type i) :
+					_d(d), _i(i) {}
+
+			public:
+				reference (const reference&) = default;
+
+				/**
+				 * Returns whether two records are equal
+				 * value_type's == is usually a template, which would not see
+				 * through the conversion.
+				 */
+				friend bool operator == (const reference& lhs, const reference& rhs) {
+					return value_type(lhs) == value_type(rhs);}
+
+				friend bool operator == (const reference& lhs, const value_type& rhs) {
+					return value_type(lhs) == rhs;}
+
+				friend bool operator == (const value_type& lhs, const reference& rhs) {
+					return lhs == value_type(rhs);}
+
+				/**
+				 * Returns a copy of the record
+				 */
+				operator value_type () const {
+					return _d->load(_i);}
+
+				/**
+				 * Overwrites every field of the record with v's
+				 */
+				reference& operator = (const value_type& v) {
+					_d->store(_i, v);
+					return *this;}
+
+				/**
+				 * Overwrites every field of the record with that record's
+				 */
+				reference& operator = (const reference& that) {
+					return *this = value_type(that);}
+
+				/**
+				 * Returns a reference to field J of the record
+				 */
+				template <std::size_t J>
+				column_type<J>& get () const {
+					return std::get<J>(_d->_columns)[_i];}
+
+				/**
+				 * Exchanges the records two proxies refer to
+				 */
+				friend void swap (reference lhs, reference rhs) {
+					value_type x = lhs;
+					lhs = rhs;
+					rhs = x;}};
+
+		// --------
+		// iterator
+		class iterator {
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag		iterator_category;
+				typedef typename MyColumnDeque::value_type		value_type;
+				typedef typename MyColumnDeque::difference_type	difference_type;
+				typedef void						pointer;
+				typedef typename MyColumnDeque::reference		reference;
+				typedef typename MyColumnDeque::size_type		size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const iterator& lhs, const iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const iterator& lhs, const iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend iterator operator + (iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend iterator operator - (iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+			private:
+				// ----
+				// data
+				MyColumnDeque*	_d;
+				size_type		idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns an iterator to the ith record of d
+				 */
+				iterator (MyColumnDeque* d, size_type i) :
+					_d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Returns a proxy for the actual record
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				iterator operator ++ (int) {
+					iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				iterator operator -- (int) {
+					iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+		// --------------
+		// const_iterator
+		class const_iterator {
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag		iterator_category;
+				typedef typename MyColumnDeque::value_type		value_type;
+				typedef typename MyColumnDeque::difference_type	difference_type;
+				typedef const value_type*				pointer;
+				typedef value_type					reference;
+				typedef typename MyColumnDeque::size_type		size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend const_iterator operator + (const_iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend const_iterator operator - (const_iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+			private:
+				// ----
+				// data
+				const MyColumnDeque*	_d;
+				size_type				idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns a const_iterator to the ith record of d
+				 */
+				const_iterator (const MyColumnDeque* d, size_type i) :
+					_d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Returns a copy of the actual record
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				const_iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				const_iterator operator ++ (int) {
+					const_iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				const_iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				const_iterator operator -- (int) {
+					const_iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				const_iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				const_iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+	public:
+		// -----------
+		// operator ==
+		/**
+		 * Returns whether both deques hold the same records, column by column
+		 */
+		friend bool operator == (const MyColumnDeque& lhs, const MyColumnDeque& rhs) {
+			return ((std::get<I>(lhs._columns) == std::get<I>(rhs._columns)) && ...);}
+
+		// ----------
+		// operator <
+		/**
+		 * Compares records lexicographically, each record by value_type's <
+		 */
+		friend bool operator < (const MyColumnDeque& lhs, const MyColumnDeque& rhs) {
+			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());}
+
+	public:
+		// -----------
+		// operator []
+		/**
+		 * Returns a proxy for the nth record
+		 */
+		reference operator [] (size_type n) {
+			assert(n < size());
+			return reference(this, n);}
+
+		/**
+		 * Returns a copy of the nth record
+		 */
+		value_type operator [] (size_type n) const {
+			assert(n < size());
+			return load(n);}
+
+		// --
+		// at
+		/**
+		 * Returns a proxy for the nth record
+		 * Throws an exception if n is out of bounds
+		 */
+		reference at (size_type n) {
+			if (n >= size())
+				throw std::out_of_range("deque::_M_range_check");
+			return (*this)[n];}
+
+		/**
+		 * Returns a copy of the nth record
+		 * Throws an exception if n is out of bounds
+		 */
+		value_type at (size_type n) const {
+			if (n >= size())
+				throw std::out_of_range("deque::_M_range_check");
+			return (*this)[n];}
+
+		// ----
+		// back
+		/**
+		 * Returns a proxy for the record at the back
+		 */
+		reference back () {
+			assert(!empty());
+			return (*this)[size() - 1];}
+
+		/**
+		 * Returns a copy of the record at the back
+		 */
+		value_type back () const {
+			assert(!empty());
+			return (*this)[size() - 1];}
+
+		// -----
+		// begin
+		/**
+		 * Returns an iterator for the first record
+		 */
+		iterator begin () {
+			return iterator(this, 0);}
+
+		/**
+		 * Returns a constant iterator for the first record
+		 */
+		const_iterator begin () const {
+			return const_iterator(this, 0);}
+
+		// -----
+		// clear
+		/**
+		 * Removes all records
+		 */
+		void clear () {
+			(std::get<I>(_columns).clear(), ...);
+			assert(valid());}
+
+		// ------
+		// column
+		/**
+		 * Returns field J of every record as one contiguous span, front to
+		 * back, valid until the next push
+		 */
+		template <std::size_t J>
+		MySpan< column_type<J> > column () {
+			MyDeque< column_type<J> >& c = std::get<J>(_columns);
+			return MySpan< column_type<J> >(c.data(), c.size());}
+
+		/**
+		 * Returns field J of every record as one constant contiguous span
+		 */
+		template <std::size_t J>
+		MySpan< const column_type<J> > column () const {
+			const MyDeque< column_type<J> >& c = std::get<J>(_columns);
+			return MySpan< const column_type<J> >(c.data(), c.size());}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the container is empty
+		 */
+		bool empty () const {
+			return !size();}
+
+		// ---
+		// end
+		/**
+		 * Returns an iterator to the position after the last record
+		 */
+		iterator end () {
+			return iterator(this, size());}
+
+		/**
+		 * Returns a constant iterator to the position after the last record
+		 */
+		const_iterator end () const {
+			return const_iterator(this, size());}
+
+		// -----
+		// front
+		/**
+		 * Returns a proxy for the first record
+		 */
+		reference front () {
+			assert(!empty());
+			return (*this)[0];}
+
+		/**
+		 * Returns a copy of the first record
+		 */
+		value_type front () const {
+			assert(!empty());
+			return (*this)[0];}
+
+		// ---
+		// get
+		/**
+		 * Returns a reference to field J of the nth record
+		 */
+		template <std::size_t J>
+		column_type<J>& get (size_type n) {
+			assert(n < size());
+			return std::get<J>(_columns)[n];}
+
+		/**
+		 * Returns a constant reference to field J of the nth record
+		 */
+		template <std::size_t J>
+		const column_type<J>& get (size_type n) const {
+			assert(n < size());
+			return std::get<J>(_columns)[n];}
+
+		// --------
+		// pop_back
+		/**
+		 * Removes the record at the back
+		 */
+		void pop_back () {
+			assert(!empty());
+			(std::get<I>(_columns).pop_back(), ...);
+			assert(valid());}
+
+		// ---------
+		// pop_front
+		/**
+		 * Removes the record at the front
+		 */
+		void pop_front () {
+			assert(!empty());
+			(std::get<I>(_columns).pop_front(), ...);
+			assert(valid());}
+
+		// ---------
+		// push_back
+		/**
+		 * Appends v's fields to the back of every column
+		 * If a column throws, the columns already pushed are popped again.
+		 */
+		void push_back (const value_type& v) {
+			push_back_from<0>(v);
+			assert(valid());}
+
+		// ----------
+		// push_front
+		/**
+		 * Prepends v's fields to the front of every column
+		 * If a column throws, the columns already pushed are popped again.
+		 */
+		void push_front (const value_type& v) {
+			push_front_from<0>(v);
+			assert(valid());}
+
+		// ----
+		// size
+		/**
+		 * Returns the number of records
+		 */
+		size_type size () const {
+			return std::get<0>(_columns).size();}
+
+		// ----
+		// swap
+		/**
+		 * Exchanges contents with that
+		 */
+		void swap (MyColumnDeque& that) {
+			(std::get<I>(_columns).swap(std::get<I>(that._columns)), ...);
+			assert(valid());}
+
+	private:
+		// ----
+		// load
+		value_type load (size_type n) const {
+			return value_type{std::get<I>(_columns)[n]...};}
+
+		// -----
+		// store
+		void store (size_type n, const value_type& v) {
+			((std::get<I>(_columns)[n] = field<I>(v)), ...);}
+
+		// --------------
+		// push_back_from
+		template <std::size_t J>
+		void push_back_from (const value_type& v) {
+			if constexpr (J < sizeof...(I)) {
+				std::get<J>(_columns).push_back(field<J>(v));
+				try {
+					push_back_from<J + 1>(v);}
+				catch (...) {
+					std::get<J>(_columns).pop_back();
+					throw;}}}
+
+		// ---------------
+		// push_front_from
+		template <std::size_t J>
+		void push_front_from (const value_type& v) {
+			if constexpr (J < sizeof...(I)) {
+				std::get<J>(_columns).push_front(field<J>(v));
+				try {
+					push_front_from<J + 1>(v);}
+				catch (...) {
+					std::get<J>(_columns).pop_front();
+					throw;}}}};
+
+#endif // ColumnDeque_h
@@ -0,0 +1,565 @@
+// -----------------
+// CompressedDeque.h
+// -----------------
+
+#ifndef CompressedDeque_h
+#define CompressedDeque_h
+
+// --------
+// includes
+#include <algorithm>	// equal, lexicographical_compare, swap
+#include <cassert>		// assert
+#include <climits>		// CHAR_BIT
+#include <cstddef>		// ptrdiff_t, size_t
+#include <iterator>		// bidirectional_iterator_tag
+#include <limits>		// numeric_limits
+#include <stdexcept>	// out_of_range
+
+#include "Deque.h"		// MyDeque
+
+// -----------------
+// MyCompressedDeque
+/**
+ * A deque of integers stored as compressed blocks of N elements
+ * Each sealed block keeps its first value and the deltas between
+ * neighbours, shifted by the smallest delta (frame of reference) and
+ * bit-packed at the width of the largest one, so monotonic stamps and
+ * counters take a byte or two per element instead of sizeof(T). Up to
+ * 2N elements at each end stay uncompressed: a full end seals N of them
+ * into a block, and an empty one unseals a block, so an end that goes
+ * back and forth across a block boundary does not encode or decode a
+ * block every time, and pushes and pops at both ends are amortized O(1).
+ * Reads decode a whole block into a one-block cache, which makes
+ * sequential scans cost one decode per N elements.
+ * Elements are values, not objects: operator[] returns a copy.
+ * Reading fills the cache, even through a const deque, so concurrent
+ * readers need a lock as writers would.
+ */
+template < typename T, std::size_t N = 128 >
+class MyCompressedDeque {
+	public:
+		// --------
+		// typedefs
+		typedef T				value_type;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+
+	private:
+		typedef unsigned long	word;
+
+		// only integers that fit in a word can be delta-coded losslessly
+		typedef char integral_value_type[std::numeric_limits<T>::is_integer ? 1 : -1];
+		typedef char value_type_fits_in_a_word[sizeof(T) <= sizeof(word) ? 1 : -1];
+		typedef char block_is_not_empty[N > 0 ? 1 : -1];
+
+		enum {word_bits = sizeof(word) * CHAR_BIT};
+
+		// -----
+		// block
+		struct block {
+			value_type		first;	// first element, the base of the deltas
+			word			min;	// smallest delta, subtracted from every packed delta
+			unsigned char	width;	// bits per packed delta
+			difference_type	offset;	// absolute position of the first word in _words
+
+			size_type words () const {
+				return ((N - 1) * width + word_bits - 1) / word_bits;}};
+
+	public:
+		// -----------
+		// operator ==
+		/**
+		 * Returns whether both deques hold equal elements in the same order
+		 */
+		friend bool operator == (const MyCompressedDeque& lhs, const MyCompressedDeque& rhs) {
+			return lhs.size() == rhs.size() and
+				std::equal(lhs.begin(), lhs.end(), rhs.begin() );}
+
+		// ----------
+		// operator <
+		/**
+		 * Returns whether lhs orders lexicographically before rhs
+		 */
+		friend bool operator < (const MyCompressedDeque& lhs, const MyCompressedDeque& rhs) {
+			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );}
+
+	private:
+		// ----
+		// data
+		MyDeque<value_type> _head;	// uncompressed elements before the first block, fewer than 2N
+		MyDeque<block> _blocks;		// sealed blocks of exactly N elements each
+		MyDeque<value_type> _tail;	// uncompressed elements after the last block, fewer than 2N
+		MyDeque<word> _words;		// packed deltas of every block, in block order
+		difference_type _origin;	// absolute position of _words[0]
+
+		mutable size_type _cached;	// index in _blocks of the block held in _cache, or size_type(-1)
+		mutable value_type _cache[N];
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return (_head.size() < 2 * N) && (_tail.size() < 2 * N) &&
+				(_blocks.empty() || (size_type)(_blocks.back().offset + _blocks.back().words() - _origin) == _words.size()) &&
+				(_cached == size_type(-1) || _cached < _blocks.size());}
+
+	public:
+		// --------------
+		// const_iterator
+		class const_iterator {
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag		iterator_category;
+				typedef typename MyCompressedDeque::value_type		value_type;
+				typedef typename MyCompressedDeque::difference_type	difference_type;
+				typedef const value_type*				pointer;
+				typedef value_type					reference;
+				typedef typename MyCompressedDeque::size_type		size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend const_iterator operator + (const_iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend const_iterator operator - (const_iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+			private:
+				// ----
+				// data
+				const MyCompressedDeque*	_d;
+				size_type			idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns a const_iterator to the ith element of d
+				 */
+				const_iterator (const MyCompressedDeque* d, size_type i)
+					: _d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Returns a copy of the actual element
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				const_iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				const_iterator operator ++ (int) {
+					const_iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				const_iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				const_iterator operator -- (int) {
+					const_iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				const_iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				const_iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+		typedef const_iterator iterator;
+
+	public:
+		// ------------
+		// constructors
+		/**
+		 * Returns an empty compressed deque
+		 */
+		MyCompressedDeque () :
+			_origin(0), _cached(size_type(-1)) {
+			assert(valid());}
+
+		// Default copy, destructor, and copy assignment.
+		// MyCompressedDeque (const MyCompressedDeque&);
+		// ~MyCompressedDeque ();
+		// MyCompressedDeque& operator = (const MyCompressedDeque&);
+
+		// -----------
+		// operator []
+		/**
+		 * Returns a copy of the nth element, decoding its block if it is not cached
+		 * The cache is mutable, so this writes even though it is const, and
+		 * two threads must not call it at once.
+		 */
+		value_type operator [] (size_type n) const {
+			if (n < _head.size())
+				return _head[n];
+			n -= _head.size();
+			const size_type k = n / N;
+			if (k < _blocks.size()) {
+				if (_cached != k) {
+					decode(_blocks[k], _cache);
+					_cached = k;}
+				return _cache[n % N];}
+			return _tail[n - _blocks.size() * N];}
+
+		// --
+		// at
+		/**
+		 * Returns a copy of the nth element
+		 * Throws an exception if n is out of bounds
+		 */
+		value_type at (size_type n) const {
+			if (n >= size())
+				throw std::out_of_range("deque::_M_range_check");
+			return (*this)[n];}
+
+		// ----
+		// back
+		/**
+		 * Returns a copy of the last element
+		 */
+		value_type back () const {
+			assert(!empty());
+			return (*this)[size() - 1];}
+
+		// -----
+		// begin
+		/**
+		 * Returns an iterator for the first element
+		 */
+		const_iterator begin () const {
+			return const_iterator(this, 0);}
+
+		// ------
+		// blocks
+		/**
+		 * Returns the number of sealed blocks
+		 */
+		size_type blocks () const {
+			return _blocks.size();}
+
+		// -----
+		// bytes
+		/**
+		 * Returns the number of bytes allocated for the elements, compressed
+		 * and not, spare capacity included
+		 * The one-block cache lives in the deque itself and is not counted.
+		 */
+		size_type bytes () const {
+			return (_head.capacity() + _tail.capacity()) * sizeof(value_type) +
+				_blocks.capacity() * sizeof(block) + _words.capacity() * sizeof(word);}
+
+		// -----
+		// clear
+		/**
+		 * Removes all elements (empties the container)
+		 */
+		void clear () {
+			_head.clear();
+			_blocks.clear();
+			_tail.clear();
+			_words.clear();
+			_origin = 0;
+			_cached = size_type(-1);
+			assert(valid());}
+
+		// ----
+		// copy
+		/**
+		 * Copies every element to x in order, decoding each block once
+		 * Returns the end of the output
+		 */
+		template <typename OI>
+		OI copy (OI x) const {
+			x = std::copy(_head.begin(), _head.end(), x);
+			value_type a[N];
+			for (size_type k = 0; k != _blocks.size(); ++k) {
+				decode(_blocks[k], a);
+				x = std::copy(a, a + N, x);}
+			return std::copy(_tail.begin(), _tail.end(), x);}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the container is empty
+		 */
+		bool empty () const {
+			return !size();}
+
+		// ---
+		// end
+		/**
+		 * Returns an iterator to the position after the last element
+		 */
+		const_iterator end () const {
+			return const_iterator(this, size());}
+
+		// -----
+		// front
+		/**
+		 * Returns a copy of the first element
+		 */
+		value_type front () const {
+			assert(!empty());
+			return (*this)[0];}
+
+		// --------
+		// pop_back
+		/**
+		 * Removes the last element, unpacking the last block if the tail is empty
+		 */
+		void pop_back () {
+			assert(!empty());
+			if (_tail.empty() && !_blocks.empty())
+				unseal_back();
+			if (!_tail.empty())
+				_tail.pop_back();
+			else
+				_head.pop_back();
+			assert(valid());}
+
+		// ---------
+		// pop_front
+		/**
+		 * Removes the first element, unpacking the first block if the head is empty
+		 */
+		void pop_front () {
+			assert(!empty());
+			if (_head.empty() && !_blocks.empty())
+				unseal_front();
+			if (!_head.empty())
+				_head.pop_front();
+			else
+				_tail.pop_front();
+			assert(valid());}
+
+		// ---------
+		// push_back
+		/**
+		 * Appends v, sealing the first N elements of the tail into a block
+		 * once it holds 2N
+		 */
+		void push_back (value_type v) {
+			_tail.push_back(v);
+			if (_tail.size() == 2 * N)
+				seal_back();
+			assert(valid());}
+
+		// ----------
+		// push_front
+		/**
+		 * Prepends v, sealing the last N elements of the head into a block
+		 * once it holds 2N
+		 */
+		void push_front (value_type v) {
+			_head.push_front(v);
+			if (_head.size() == 2 * N)
+				seal_front();
+			assert(valid());}
+
+		// ----
+		// size
+		/**
+		 * Returns the current number of elements
+		 */
+		size_type size () const {
+			return _head.size() + _blocks.size() * N + _tail.size();}
+
+		// ----
+		// swap
+		/**
+		 * Swaps the data of this with the data of that
+		 */
+		void swap (MyCompressedDeque& that) {
+			_head.swap(that._head);
+			_blocks.swap(that._blocks);
+			_tail.swap(that._tail);
+			_words.swap(that._words);
+			std::swap(_origin, that._origin);
+			_cached = that._cached = size_type(-1);
+			assert(valid());}
+
+	private:
+		// ------
+		// encode
+		/**
+		 * Packs the N elements at v into a block and its words, returning the block
+		 * The block's offset is left for the caller to set
+		 */
+		block encode (const value_type* v, word* w) const {
+			word d[N];
+			block b;
+			b.first = v[0];
+			b.min = 0;
+			// deltas are taken modulo 2^word_bits, so any T round-trips
+			for (size_type i = 1; i < N; ++i)
+				d[i] = (word)v[i] - (word)v[i - 1];
+			if (N > 1)
+				b.min = d[1];
+			for (size_type i = 2; i < N; ++i)
+				if ((long)d[i] < (long)b.min)
+					b.min = d[i];
+			word m = 0;
+			for (size_type i = 1; i < N; ++i) {
+				d[i] -= b.min;
+				m |= d[i];}
+			b.width = 0;
+			while (m) {
+				++b.width;
+				m >>= 1;}
+			std::fill(w, w + b.words(), word(0));
+			for (size_type i = 1; b.width && i < N; ++i) {
+				const size_type p = (i - 1) * b.width;
+				const size_type k = p / word_bits;
+				const size_type s = p % word_bits;
+				w[k] |= d[i] << s;
+				if (s + b.width > word_bits)
+					w[k + 1] |= d[i] >> (word_bits - s);}
+			return b;}
+
+		// ------
+		// decode
+		/**
+		 * Unpacks block b into the N elements at x
+		 * Unpacking and the running sum are separate loops; the first has no
+		 * carried dependency, so the compiler can vectorize it
+		 */
+		void decode (const block& b, value_type* x) const {
+			word d[N];
+			const size_type o = b.offset - _origin;
+			const word mask = b.width == word_bits ? ~word(0) : (word(1) << b.width) - 1;
+			for (size_type i = 1; i < N; ++i) {
+				const size_type p = (i - 1) * b.width;
+				const size_type k = o + p / word_bits;
+				const size_type s = p % word_bits;
+				word y = b.width ? _words[k] >> s : 0;
+				if (s + b.width > word_bits)
+					y |= _words[k + 1] << (word_bits - s);
+				d[i] = y & mask;}
+			word a = b.first;
+			x[0] = b.first;
+			for (size_type i = 1; i < N; ++i) {
+				a += d[i] + b.min;
+				x[i] = (value_type)a;}}
+
+		// ---------
+		// seal_back
+		/**
+		 * Seals the first N elements of the tail, those next to the blocks
+		 */
+		void seal_back () {
+			assert(_tail.size() >= N);
+			word w[N];
+			block b = encode(_tail.data(), w);
+			b.offset = _origin + (difference_type)_words.size();
+			for (size_type i = 0; i != b.words(); ++i)
+				_words.push_back(w[i]);
+			_blocks.push_back(b);
+			for (size_type i = 0; i != N; ++i)
+				_tail.pop_front();}
+
+		// ----------
+		// seal_front
+		/**
+		 * Seals the last N elements of the head, those next to the blocks
+		 */
+		void seal_front () {
+			assert(_head.size() >= N);
+			word w[N];
+			block b = encode(_head.data() + (_head.size() - N), w);
+			for (size_type i = b.words(); i != 0; --i)
+				_words.push_front(w[i - 1]);
+			_origin -= (difference_type)b.words();
+			b.offset = _origin;
+			_blocks.push_front(b);
+			for (size_type i = 0; i != N; ++i)
+				_head.pop_back();
+			_cached = size_type(-1);}
+
+		// -----------
+		// unseal_back
+		void unseal_back () {
+			assert(_tail.empty());
+			value_type a[N];
+			const block& b = _blocks.back();
+			decode(b, a);
+			for (size_type i = 0; i != N; ++i)
+				_tail.push_back(a[i]);
+			for (size_type i = 0; i != b.words(); ++i)
+				_words.pop_back();
+			_blocks.pop_back();
+			_cached = size_type(-1);}
+
+		// ------------
+		// unseal_front
+		void unseal_front () {
+			assert(_head.empty());
+			value_type a[N];
+			const block& b = _blocks.front();
+			decode(b, a);
+			for (size_type i = 0; i != N; ++i)
+				_head.push_back(a[i]);
+			for (size_type i = 0; i != b.words(); ++i)
+				_words.pop_front();
+			_origin += (difference_type)b.words();
+			_blocks.pop_front();
+			_cached = size_type(-1);}};
+
+#endif // CompressedDeque_h
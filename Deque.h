@@ -5,18 +5,41 @@
 #ifndef Deque_h
 #define Deque_h
 #define DEBUG !true
-#define WIDTH 50 // length of sub-arrays
 
 // --------
 // includes
-#include <algorithm>	// copy, equal, lexicographical_compare, max, swap
+#include <algorithm>	// copy, copy_backward, equal, lexicographical_compare, max, swap
 #include <cassert>		// assert
-#include <iterator>		// iterator, bidirectional_iterator_tag
+#include <cstring>		// memmove
+#include <iterator>		// iterator, bidirectional_iterator_tag, distance, iterator_traits
+#include <limits>		// numeric_limits
 #include <memory>		// allocator
-#include <stdexcept>	// out_of_range
+#include <stdexcept>	// out_of_range, runtime_error
 #include <utility>		// !=, <=, >, >=
 #include <iostream>
 
+#if __cplusplus >= 201103L
+#include <initializer_list>	// initializer_list
+#endif
+
+#include "Mapping.h"	// MyMapping, MyMappingTally
+#include "Snapshot.h"	// MyChecksum, MySnapshot, MySnapshotIn, MySnapshotOut
+
+// -----------
+// DEQUE_TRACE
+// Compiling with -DDEQUE_TRACE lets MyTrace record MyDeque's operations;
+// without it the hooks below expand to nothing.
+#ifdef DEQUE_TRACE
+#include "Trace.h"		// MyTrace
+#define MY_DEQUE_TRACE(o, n)		MyTrace::scope<MyDeque> _trace(this, MyTrace::o, (n))
+#define MY_DEQUE_TRACE_PAIR(o, d, c)	MyTrace::scope<MyDeque> _trace(this, MyTrace::o, (d), (c))
+#define MY_DEQUE_TRACE_ARG(n)		_trace.arg(n)
+#else
+#define MY_DEQUE_TRACE(o, n)
+#define MY_DEQUE_TRACE_PAIR(o, d, c)
+#define MY_DEQUE_TRACE_ARG(n)
+#endif
+
 // -----
 // using
 using std::rel_ops::operator!=;
@@ -26,13 +49,35 @@ using std::rel_ops::operator>=;
 using std::cerr;
 using std::endl;
 
+// ---------
+// construct
 // -------
 // destroy
+// Single elements go through allocator_traits where it exists, since
+// C++20 std::allocator no longer has construct and destroy members.
+#if __cplusplus >= 201103L
+template <typename A, typename P, typename U>
+void construct (A& a, P p, const U& v) {
+	std::allocator_traits<A>::construct(a, &*p, v);}
+
+template <typename A, typename P>
+void destroy (A& a, P p) {
+	std::allocator_traits<A>::destroy(a, &*p);}
+#else
+template <typename A, typename P, typename U>
+void construct (A& a, P p, const U& v) {
+	a.construct(&*p, v);}
+
+template <typename A, typename P>
+void destroy (A& a, P p) {
+	a.destroy(&*p);}
+#endif
+
 template <typename A, typename BI>
 BI destroy (A& a, BI b, BI e) {
 	while (b != e) {
 		--e;
-		a.destroy(&*e);}
+		destroy(a, e);}
 	return b;}
 
 // ------------------
@@ -40,10 +85,9 @@ BI destroy (A& a, BI b, BI e) {
 template <typename A, typename II, typename BI>
 BI uninitialized_copy (A& a, II b, II e, BI x) {
 	BI p = x;
-	assert(b!=e);
 	try {
 		while (b != e) {
-			a.construct(&*x, *b);
+			construct(a, x, *b);
 			++b;
 			++x;}}
 	catch (...) {
@@ -59,13 +103,20 @@ BI uninitialized_fill (A& a, BI b, BI e, const U& v) {
 	assert(p == b);
 	try {
 		while (b != e) {
-			a.construct(&*b, v);
+			construct(a, b, v);
 			++b;}}
 	catch (...) {
 		destroy(a, p, b);
 		throw;}
 	return e;}
 
+// ------------
+// integral_tag
+// Tells a range template called with two integers (MyDeque<int> x(5, 7))
+// to behave as the count-and-value overload, as the standard requires.
+template <bool B>
+struct integral_tag {};
+
 // -----
 // MyDeque
 template < typename T, typename A = std::allocator<T> >
@@ -79,14 +130,11 @@ class MyDeque {
 		typedef typename allocator_type::size_type		size_type;
 		typedef typename allocator_type::difference_type	difference_type;
 
-		typedef typename allocator_type::pointer		pointer;	// T*
-		typedef typename allocator_type::const_pointer		const_pointer;
+		typedef value_type*					pointer;
+		typedef const value_type*				const_pointer;
 
-		typedef typename allocator_type::reference		reference;
-		typedef typename allocator_type::const_reference	const_reference;
-		
-		typedef typename allocator_type::template rebind<T*>::other pointer_allocator_type;
-		typedef typename pointer_allocator_type::pointer	pointer_pointer; // T**
+		typedef value_type&					reference;
+		typedef const value_type&				const_reference;
 
 	public:
 		// -----------
@@ -110,12 +158,6 @@ class MyDeque {
 		// ----
 		// data
 		allocator_type _a;	// T allocator
-		pointer_allocator_type _pa; // T* allocator
-		
-		pointer_pointer _fr;	// front of outer array
-		pointer_pointer _ba;	// back of outer array
-		pointer _b;		// beginning of inner array
-		pointer _e;		// end of inner array
 
 		pointer _front;		// front of allocated space
 		pointer _begin;		// beginning of used space
@@ -175,6 +217,13 @@ class MyDeque {
 				friend iterator operator - (iterator lhs, difference_type n) {
 					return lhs -= n;}
 
+				/**
+				 * Returns the number of elements from rhs to lhs
+				 */
+				friend difference_type operator - (const iterator& lhs, const iterator& rhs) {
+					assert(lhs._d == rhs._d);
+					return lhs.idx - rhs.idx;}
+
 			private:
 				// ----
 				// data
@@ -428,64 +477,82 @@ class MyDeque {
 		 * Returns a Deque with the specified allocator
 		 */
 		explicit MyDeque (const allocator_type& a = allocator_type() )
-			: _a(a), _pa(), _fr(0), _ba(0), _b(0), _e(0), _front(0), _begin(0), _end(0), _back(0){
+			: _a(a), _front(0), _begin(0), _end(0), _back(0){
+				MY_DEQUE_TRACE(create, 0);
 				assert(valid() );}
 
 		/**
 		 * Returns a Deque with the specified size, values, and allocator
 		 */
 		explicit MyDeque (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type())
-			: _a(a), _pa() {
-
-			// we need s / WIDTH full arrays, and possibly 1 partial array
-			size_type num_arrays = s / WIDTH + (s % WIDTH? 1 : 0);
-			// allocate outer array and save pointer to front
-			_fr = _pa.allocate(num_arrays);
-			// allocate inner arrays
-			for (size_type i = 0; i < num_arrays; ++i) {
-				_fr[i] = _a.allocate(WIDTH);
-			}
-			// set pointer to back
-			_ba = _fr + num_arrays;
-			// set pointer to beginning of data
-			_b = _fr[0];
-			// offset < WIDTH if we have a partial array
-			size_type offset = WIDTH - (WIDTH * num_arrays - s); 
-			assert 	(0 < offset and offset <= WIDTH);
-			// set pointer to end of data
-			_e = _fr[num_arrays - 1] + offset;
-			// fill inner arrays with default value
-			for (size_type i = 0; i < num_arrays; ++i) {
-				_a.deallocate(_fr[i], WIDTH);
-			}
-			_pa.deallocate(_fr, num_arrays);
-			_front = _begin = _a.allocate(s);
-			_end = _back = _begin + s;
-			uninitialized_fill(_a, begin(), end(), v);
+			: _a(a), _front(0), _begin(0), _end(0), _back(0) {
+			MY_DEQUE_TRACE(create, s);
+			if (s) {
+				_front = _begin = allocate(s);
+				_end = _back = _begin + s;
+				try {
+					uninitialized_fill(_a, begin(), end(), v);}
+				catch (...) {
+					deallocate(_front, s);
+					throw;}}
 			assert(valid());}
 
 		/**
 		 * Returns a Deque that is a copy of the specified Deque
 		 */
 		MyDeque (const MyDeque& that) 
-			: _a(that._a) {
-			_pa = pointer_allocator_type();
-			_fr = _ba = 0;
-			_b = _e;
-			_front = _begin = _a.allocate(that.size());
-			_end = _back = _begin + that.size();
-			uninitialized_copy(_a, that.begin(), that.end(), begin()); 
+			: _a(that._a), _front(0), _begin(0), _end(0), _back(0) {
+			MY_DEQUE_TRACE_PAIR(copy, &that, false);
+			if (!that.empty()) {
+				_front = _begin = allocate(that.size());
+				_end = _back = _begin + that.size();
+				try {
+					uninitialized_copy(_a, that.begin(), that.end(), begin());}
+				catch (...) {
+					deallocate(_front, that.size());
+					throw;}}
 			assert(valid());}
 
+		/**
+		 * Returns a Deque holding copies of the elements of [b, e)
+		 * A forward range is measured first and copied into one allocation;
+		 * an input range is read once, growing in blocks.
+		 */
+		template <typename II>
+		MyDeque (II b, II e, const allocator_type& a = allocator_type())
+			: _a(a), _front(0), _begin(0), _end(0), _back(0) {
+			MY_DEQUE_TRACE(create, 0);
+			try {
+				assign(b, e);}
+			catch (...) {
+				if (_front) {
+					clear();
+					deallocate(_front, _back - _front);}
+				throw;}
+			MY_DEQUE_TRACE_ARG(size());
+			assert(valid());}
+
+#if __cplusplus >= 201103L
+		/**
+		 * Returns a Deque holding copies of the elements of l, in one allocation
+		 */
+		MyDeque (std::initializer_list<value_type> l, const allocator_type& a = allocator_type())
+			: _a(a), _front(0), _begin(0), _end(0), _back(0) {
+			MY_DEQUE_TRACE(create, l.size());
+			assign(l.begin(), l.end());
+			assert(valid());}
+#endif
+
 		// ----------
 		// destructor
 		/**
 		 * Destroys this Deque
 		 */
 		~MyDeque () {
+			MY_DEQUE_TRACE(destroy, 0);
 			if (_front) {
 				clear();
-				_a.deallocate(_front, (_back - _front));}
+				deallocate(_front, (_back - _front));}
 			assert(valid() );}
 
 		// ----------
@@ -496,11 +563,12 @@ class MyDeque {
 		MyDeque& operator = (const MyDeque& rhs) {
 			if (this == &rhs)
 				return *this;
+			MY_DEQUE_TRACE_PAIR(copy_assign, &rhs, true);
 			if (rhs.size() == size())
 				std::copy(rhs.begin(), rhs.end(), begin());
 			else if (rhs.size() < size()) {
 				std::copy(rhs.begin(), rhs.end(), begin());
-				resize(rhs.size());}	
+				_end = destroy(_a, _begin + rhs.size(), _end);}	
 			else if ((unsigned)rhs.size() <= (unsigned)(_back - _begin)) {
 				std::copy(rhs.begin(), rhs.begin() + size(), begin());
 				_end = &(*uninitialized_copy(_a, rhs.begin() + size(), rhs.end(), end()));}
@@ -511,12 +579,23 @@ class MyDeque {
 			assert(valid() );
 			return *this;}
 
+#if __cplusplus >= 201103L
+		/**
+		 * Returns a reference of this Deque after replacing its elements with l's
+		 */
+		MyDeque& operator = (std::initializer_list<value_type> l) {
+			MY_DEQUE_TRACE(assign, l.size());
+			assign(l);
+			return *this;}
+#endif
+
 		// -----------
 		// operator []
 		/**
 		 * Returns a reference to the nth element
 		 */
 		reference operator [] (size_type n) {
+			MY_DEQUE_TRACE(index, n);
 			pointer r = _begin + n;
 			return *r;}
 
@@ -524,6 +603,7 @@ class MyDeque {
 		 * Returns a constant reference to the nth element
 		 */
 		const_reference operator [] (size_type n) const {
+			MY_DEQUE_TRACE(index, n);
 			return const_cast<MyDeque*>(this)->operator[](n);}
 
 		// --
@@ -533,6 +613,7 @@ class MyDeque {
 		 * Throws an exception if n is out of bounds
 		 */
 		reference at (size_type n) {
+			MY_DEQUE_TRACE(index, n);
 			if (n >= size() )
 				throw std::out_of_range("deque::_M_range_check");
 			return (*this)[n];}
@@ -542,16 +623,61 @@ class MyDeque {
  		 * Throws an exception if n is out of bounds 
 		 */
 		const_reference at (size_type index) const {
+			MY_DEQUE_TRACE(index, index);
 			if (index >= size() )
 				throw std::out_of_range("deque::_M_range_check");
 			return const_cast<MyDeque*>(this)->at(index);}
 
+		// ------
+		// assign
+		/**
+		 * Replaces the elements with s copies of v
+		 * Reuses the buffer if s fits in it, otherwise allocates once
+		 */
+		void assign (size_type s, const_reference v) {
+			MY_DEQUE_TRACE(assign, s);
+			const size_type capacity = _back - _front;
+			if (s <= capacity) {
+				// v may live in this deque
+				value_type x(v);
+				clear();
+				_begin = _end = _front + (capacity - s) / 2;
+				_end = uninitialized_fill(_a, _begin, _begin + s, x);}
+			else {
+				MyDeque x(s, v, _a);
+				swap(x);}
+			assert(valid());}
+
+		/**
+		 * Replaces the elements with copies of the elements of [b, e), which
+		 * must not point into this Deque
+		 * A forward range is measured first and copied into the buffer if it
+		 * fits or else into one new allocation; an input range is read once,
+		 * growing in blocks.
+		 */
+		template <typename II>
+		void assign (II b, II e) {
+			MY_DEQUE_TRACE(assign, 0);
+			assign(b, e, integral_tag<std::numeric_limits<II>::is_integer>());
+			MY_DEQUE_TRACE_ARG(size());
+			assert(valid());}
+
+#if __cplusplus >= 201103L
+		/**
+		 * Replaces the elements with copies of l's
+		 */
+		void assign (std::initializer_list<value_type> l) {
+			MY_DEQUE_TRACE(assign, l.size());
+			assign(l.begin(), l.end());}
+#endif
+
 		// ----
 		// back
 		/**
 		 * Returns a reference of the element at the back
 		 */
 		reference back () {
+			MY_DEQUE_TRACE(index, size() - 1);
 			assert(! empty());
 			return *(_end - 1);}
 
@@ -559,6 +685,7 @@ class MyDeque {
 		 * Returns a constant reference of the element at the back
 		 */
 		const_reference back () const {
+			MY_DEQUE_TRACE(index, size() - 1);
 			return const_cast<MyDeque*>(this)->back();}
 
 		// -----
@@ -575,15 +702,41 @@ class MyDeque {
 		const_iterator begin () const {
 			return const_iterator(this, 0);}
 
+		// --------
+		// capacity
+		/**
+		 * Returns the number of elements the allocation holds, spare room at
+		 * both ends included
+		 */
+		size_type capacity () const {
+			return _back - _front;}
+
 		// -----
 		// clear
 		/**
 		 * Removes all elements (empties the container)
 		 */
 		void clear () {
-			resize(0);
+			MY_DEQUE_TRACE(clear, 0);
+			_end = destroy(_a, _begin, _end);
 			assert(valid());}
 
+		// ----
+		// data
+		/**
+		 * Returns a pointer to the first element
+		 * The elements are contiguous, so [data(), data() + size()) is a valid
+		 * range until the next push, resize, or insert.
+		 */
+		pointer data () {
+			return _begin;}
+
+		/**
+		 * Returns a constant pointer to the first element
+		 */
+		const_pointer data () const {
+			return _begin;}
+
 		// -----
 		// empty
 		/**
@@ -612,13 +765,11 @@ class MyDeque {
 		 * Removes the element at iterator position pos and returns the position of the next element
 		 */
 		iterator erase (iterator pos) {
-			if(pos == end() - 1)
-				pop_back();
-			else {
-				std::copy(pos+1, end(), pos);
-				resize(size()-1);}
+			MY_DEQUE_TRACE(erase, pos - begin());
+			std::copy(pos+1, end(), pos);
+			pop_back();
 			assert(valid() );
-			return iterator(this);}
+			return pos;}
 
 		// -----
 		// front
@@ -626,12 +777,14 @@ class MyDeque {
 		 * Returns the first element
 		 */
 		reference front () {
+			MY_DEQUE_TRACE(index, 0);
 			return *(_begin);}
 
 		/**
 		 * Returns the first element
 		 */
 		const_reference front () const {
+			MY_DEQUE_TRACE(index, 0);
 			return const_cast<MyDeque*>(this)->front();}
 
 		// ------
@@ -640,14 +793,92 @@ class MyDeque {
 		 * Inserts a copy of v before iterator position pos and returns the position of the new element
 		 */
 		iterator insert (iterator pos, const_reference v) {
+			MY_DEQUE_TRACE(insert, pos - begin());
 			if(pos == end() )
 				push_back(v);
 			else {
-				resize(size()+1);
-				std::copy(pos, end(), pos+1);
-				*pos = v;}
+				// v may live in this deque, and the shift moves it
+				value_type x(v);
+				push_back(back());
+				std::copy_backward(pos, end() - 2, end() - 1);
+				*pos = x;}
 			assert(valid());
-			return iterator(this);}
+			return pos;}
+
+		// ----
+		// load
+		/**
+		 * Replaces the elements with those of a raw snapshot read from in
+		 * The payload is read straight into the buffer in pieces of about
+		 * MySnapshot::block bytes. If in can seek, the snapshot's size is
+		 * checked against it and the buffer allocated once; otherwise the
+		 * buffer doubles as pieces arrive, so a header claiming more than
+		 * in holds costs no more than in does.
+		 * Throws runtime_error, leaving this Deque alone, if in does not
+		 * hold a raw snapshot of Ts or its checksum is wrong
+		 */
+		void load (std::istream& in) {
+			(void)sizeof(char[is_mappable<T>::value ? 1 : -1]);
+			MY_DEQUE_TRACE(assign, 0);
+			MySnapshot h;
+			h.read(in);
+			h.check(sizeof(T), true);
+			MyDeque x(_a);
+			if (h.fits(in) && h.count) {
+				x._front = x._begin = x._end = x.allocate(h.count);
+				x._back = x._front + h.count;}
+			// pieces of a multiple of 8 bytes, as MyChecksum needs
+			const size_type k = std::max<size_type>(8, (MySnapshot::block / sizeof(T)) & ~size_type(7));
+			MyChecksum c;
+			for (uint64_t i = 0; i != h.count; ) {
+				const size_type n = std::min<uint64_t>(k, h.count - i);
+				if ((size_type)(x._back - x._end) < n)
+					x.make_room(x.size() + std::max(x.size(), n));
+				// a T is trivially copyable, so its bytes are a T
+				if (!in.read(reinterpret_cast<char*>(x._end), n * sizeof(T)))
+					throw std::runtime_error("deque::load: truncated snapshot");
+				c.add(x._end, n * sizeof(T));
+				x._end += n;
+				i += n;}
+			if (c.value() != h.checksum)
+				throw std::runtime_error("deque::load: bad checksum");
+			swap(x);
+			MY_DEQUE_TRACE_ARG(size());
+			assert(valid());}
+
+		/**
+		 * Replaces the elements with those of a snapshot written by
+		 * save(out, s), reading each with s.read(in), which returns a T
+		 * The payload is read through a MySnapshotIn, one block at a time.
+		 * The buffer is allocated once, at the snapshot's size, if in can
+		 * seek and the payload has a byte per element; otherwise it grows.
+		 * Throws runtime_error, leaving this Deque alone, if in does not
+		 * hold such a snapshot of Ts or its checksum is wrong
+		 */
+		template <typename S>
+		void load (std::istream& in, S s) {
+			MY_DEQUE_TRACE(assign, 0);
+			MySnapshot h;
+			h.read(in);
+			h.check(sizeof(T), false);
+			MyDeque x(_a);
+			if (h.fits(in) && h.count && h.count <= h.bytes) {
+				x._front = x._begin = x._end = x.allocate(h.count);
+				x._back = x._front + h.count;}
+			MySnapshotIn b(in, h.bytes);
+			std::istream buffer(&b);
+			for (uint64_t i = 0; i != h.count; ++i) {
+				const value_type v = s.read(buffer);
+				if (!buffer)
+					throw std::runtime_error("deque::load: truncated snapshot");
+				x.push_back(v);}
+			if (!b.finish())
+				throw std::runtime_error("deque::load: truncated snapshot");
+			if (b.checksum() != h.checksum)
+				throw std::runtime_error("deque::load: bad checksum");
+			swap(x);
+			MY_DEQUE_TRACE_ARG(size());
+			assert(valid());}
 
 		// --------
 		// pop_back
@@ -655,15 +886,19 @@ class MyDeque {
 		 * Removes the last element (does not return it)
 		 */
 		void pop_back () {
+			MY_DEQUE_TRACE(pop_back, 0);
 			assert(!empty() );
-			resize(size() - 1);
+			--_end;
+			destroy(_a, _end);
 			assert(valid());}
 
 		/**
 		 * Removes the first element (doest not return it)
 		 */
 		void pop_front () {
-			destroy(_a, begin(), begin()+1);
+			MY_DEQUE_TRACE(pop_front, 0);
+			assert(!empty() );
+			destroy(_a, _begin);
 			++_begin;
 			assert(valid() );}
 
@@ -673,6 +908,7 @@ class MyDeque {
 		 * Appends a copy of v at the end
 		 */
 		void push_back (const_reference v) {
+			MY_DEQUE_TRACE(push_back, 0);
 			resize(size() + 1, v);
 			assert(valid());}
 
@@ -682,11 +918,15 @@ class MyDeque {
 		 * Inserts a copy of v at the beginning
 		 */
 		void push_front (const_reference v) {
+			MY_DEQUE_TRACE(push_front, 0);
 			if (_front == _begin) {
-				resize(size() + 1);
-				pop_back();}	
-			--_begin;
-			_a.construct(&*begin(), v);	
+				// v may live in this deque, and make_room relocates it
+				value_type x(v);
+				make_room(size() + 1);
+				push_front(x);}
+			else {
+				construct(_a, _begin - 1, v);
+				--_begin;}
 			assert(valid());}
 
 		// ------
@@ -695,28 +935,70 @@ class MyDeque {
 		 * Changes the number of elements to num (if size() grows new elements are created by their default constructor)
 		 */
 		void resize (size_type s, const_reference v = value_type()) {
+			MY_DEQUE_TRACE(resize, s);
 			if (s == size())
 				return;
 			if (s < size())
-				_end = &*destroy(_a, begin() + s, end() );
-			else if ((unsigned)s <= (unsigned)(_end -_front) && (unsigned)s <= (unsigned)(_back - _begin))
-				_end = &*uninitialized_fill(_a, end(), begin() + s, v);
-			else {		// allocate more capacity
-				size_type capacity = std::max(s, 2 * size());
-				size_type temp1 = (capacity - s) / 2;
-				if (temp1 == 0) {
-					capacity += 3;}
-				temp1 = (capacity - s) / 2;
-				size_type temp2 = (capacity - s) % 2? temp1 + 1: temp1;
-				MyDeque x(capacity, v);
-				std::copy(begin(), end(), x.begin()+temp1);
-				destroy(x._a, x.begin(), x.begin()+temp1);
-				destroy(x._a, x.end()-temp2, x.end());
-				x._begin += temp1;
-				x._end -= temp2;
-				swap(x);}
+				_end = destroy(_a, _begin + s, _end);
+			else if (s <= (size_type)(_back - _begin))
+				_end = uninitialized_fill(_a, _end, _begin + s, v);
+			else {
+				value_type x(v);
+				make_room(s);
+				_end = uninitialized_fill(_a, _end, _begin + s, x);}
 			assert(valid() );}
 
+		// ----
+		// save
+		/**
+		 * Writes a raw snapshot (see MySnapshot) of the elements to out
+		 * The elements' bytes are the payload, written in MySnapshot::block
+		 * pieces; T must be trivially copyable.
+		 * Throws runtime_error if out fails
+		 */
+		void save (std::ostream& out) const {
+			(void)sizeof(char[is_mappable<T>::value ? 1 : -1]);
+			MySnapshot h(sizeof(T), MySnapshot::raw, size(), size() * sizeof(T));
+			MyChecksum c;
+			c.add(_begin, h.bytes);
+			h.checksum = c.value();
+			h.write(out);
+			const char* p = reinterpret_cast<const char*>(_begin);
+			for (std::size_t i = 0; i < h.bytes; i += MySnapshot::block)
+				out.write(p + i, std::min<std::size_t>(MySnapshot::block, h.bytes - i));
+			if (!out)
+				throw std::runtime_error("deque::save: write failed");}
+
+		/**
+		 * Writes a snapshot of the elements to out, with s.write(out, v)
+		 * writing each v
+		 * The header's length and checksum come before the payload, so the
+		 * elements are serialized twice: once through a MySnapshotOut that
+		 * only measures, and once through one that writes to out. Neither
+		 * holds more than a block of the payload.
+		 * Throws runtime_error if out fails, or if s writes different bytes
+		 * the second time
+		 */
+		template <typename S>
+		void save (std::ostream& out, S s) const {
+			MySnapshotOut m;
+			std::ostream measure(&m);
+			for (const_pointer p = _begin; p != _end; ++p)
+				s.write(measure, *p);
+			m.finish();
+			MySnapshot h(sizeof(T), 0, size(), m.bytes());
+			h.checksum = m.checksum();
+			h.write(out);
+			MySnapshotOut w(&out);
+			std::ostream buffer(&w);
+			for (const_pointer p = _begin; p != _end; ++p)
+				s.write(buffer, *p);
+			w.finish();
+			if (!out)
+				throw std::runtime_error("deque::save: write failed");
+			if (w.bytes() != h.bytes || w.checksum() != h.checksum)
+				throw std::runtime_error("deque::save: serializer is not repeatable");}
+
 		// ----
 		// size
 		/**
@@ -731,6 +1013,7 @@ class MyDeque {
 		 * Swaps the data of this with the data of that
 		 */
 		void swap (MyDeque& that) {
+			MY_DEQUE_TRACE_PAIR(swap, &that, true);
 			if (_a == that._a) {
 				std::swap(_front, that._front);
 				std::swap(_begin, that._begin);
@@ -740,5 +1023,131 @@ class MyDeque {
 				MyDeque x(*this);
 				*this = that;
 				that = x;}
-			assert(valid() );}};
+			assert(valid() );}
+
+	private:
+		// --------
+		// allocate
+		/**
+		 * Returns room for n elements, mapped if n is large enough (see MyMapping)
+		 */
+		pointer allocate (size_type n) {
+			return MyMapping<T, A>::allocate(_a, n);}
+
+		// ----------
+		// deallocate
+		void deallocate (pointer p, size_type n) {
+			MyMapping<T, A>::deallocate(_a, p, n);}
+
+		// ------
+		// assign
+		template <typename I>
+		void assign (I s, I v, integral_tag<true>) {
+			assign(size_type(s), value_type(v));}
+
+		template <typename II>
+		void assign (II b, II e, integral_tag<false>) {
+			assign(b, e, typename std::iterator_traits<II>::iterator_category());}
+
+		template <typename II>
+		void assign (II b, II e, std::input_iterator_tag) {
+			// the first block holds this many, and each block after doubles the size
+			const size_type block = 16;
+			clear();
+			while (b != e) {
+				if (_end == _back)
+					make_room(size() + std::max(size(), block));
+				construct(_a, _end, *b);
+				++_end;
+				++b;}}
+
+		template <typename FI>
+		void assign (FI b, FI e, std::forward_iterator_tag) {
+			const size_type s = std::distance(b, e);
+			const size_type capacity = _back - _front;
+			if (s <= capacity) {
+				clear();
+				_begin = _end = _front + (capacity - s) / 2;
+				_end = uninitialized_copy(_a, b, e, _begin);
+				return;}
+			pointer f = allocate(s);
+			try {
+				uninitialized_copy(_a, b, e, f);}
+			catch (...) {
+				deallocate(f, s);
+				throw;}
+			if (_front) {
+				clear();
+				deallocate(_front, capacity);}
+			_front = _begin = f;
+			_end = _back = f + s;}
+
+		// ---------
+		// make_room
+		/**
+		 * Makes room for s elements from _begin with at least one free slot in front
+		 * Recenters in place when the free space is at least half of s, so
+		 * steady FIFO use never allocates; otherwise grows to max(s, 2 * size())
+		 * and copies each element exactly once. A mapped buffer (see MyMapping)
+		 * grows with mremap instead, leaving the elements where they are unless
+		 * the front has no free slot left.
+		 */
+		void make_room (size_type s) {
+			const size_type n = size();
+			size_type capacity = _back - _front;
+			if (s <= capacity && s <= 2 * (capacity - s) && (capacity - s) / 2 > 0) {
+				pointer b = _front + (capacity - s) / 2;
+				if (b < _begin)
+					for (pointer p = _begin, q = b; p != _end; ++p, ++q) {
+						construct(_a, q, *p);
+						destroy(_a, p);}
+				else
+					for (pointer p = _end, q = b + n; p != _begin; ) {
+						construct(_a, --q, *--p);
+						destroy(_a, p);}
+				_begin = b;
+				_end = b + n;}
+			else {
+				capacity = std::max(s, 2 * size());
+				if ((capacity - s) / 2 == 0)
+					capacity += 3;
+				if (MyMapping<T, A>::mapped(capacity)) {
+					grow(s, capacity);
+					return;}
+				pointer f = allocate(capacity);
+				pointer b = f + (capacity - s) / 2;
+				try {
+					uninitialized_copy(_a, _begin, _end, b);}
+				catch (...) {
+					deallocate(f, capacity);
+					throw;}
+				if (_front) {
+					destroy(_a, _begin, _end);
+					deallocate(_front, _back - _front);}
+				_front = f;
+				_begin = b;
+				_end = b + n;
+				_back = f + capacity;}
+			assert(_front < _begin && s <= (size_type)(_back - _begin) );}
+
+		// ----
+		// grow
+		/**
+		 * make_room's growth to capacity for a trivially copyable T
+		 */
+		void grow (size_type s, size_type capacity) {
+			const size_type n = size();
+			const size_type offset = _begin - _front;
+			pointer f = MyMapping<T, A>::reallocate(_a, _front, _back - _front, capacity);
+			pointer b = f + offset;
+			if (!offset || offset + s > capacity) {
+				b = f + (capacity - s) / 2;
+				std::memmove(static_cast<void*>(b), f + offset, n * sizeof(T));
+				MyMappingTally::get().copied += n * sizeof(T);}
+			_front = f;
+			_begin = b;
+			_end = b + n;
+			_back = f + capacity;
+			assert(_front < _begin && s <= (size_type)(_back - _begin) );}};
+
 #endif // Deque_h
@@ -0,0 +1,804 @@
+// -----------
+// GapDeque.h
+// -----------
+
+#ifndef GapDeque_h
+#define GapDeque_h
+
+// --------
+// includes
+#include <algorithm>	// equal, lexicographical_compare, max, swap
+#include <cassert>		// assert
+#include <iterator>		// bidirectional_iterator_tag
+#include <memory>		// allocator
+#include <stdexcept>	// out_of_range
+
+#include "Deque.h"		// construct, destroy, uninitialized_copy, uninitialized_fill
+
+// ----------
+// MyGapDeque
+/**
+ * A deque stored as a gap buffer: one allocation holding free space, a
+ * prefix, a gap of raw storage, a suffix, and more free space. The gap
+ * sits at the cursor, so insert and erase at the cursor are O(1) and
+ * moving the cursor costs O(distance).
+ * insert and erase move the cursor to their position first, so a run of
+ * edits around one spot never shifts the rest of the elements.
+ * The push and pop operations work in the free space at the ends and
+ * leave the cursor alone, so FIFO use costs amortized O(1) as in MyDeque.
+ */
+template < typename T, typename A = std::allocator<T> >
+class MyGapDeque {
+	public:
+		// --------
+		// typedefs
+		typedef A						allocator_type;
+		typedef typename allocator_type::value_type		value_type;
+
+		typedef typename allocator_type::size_type		size_type;
+		typedef typename allocator_type::difference_type	difference_type;
+
+		typedef value_type*					pointer;
+		typedef const value_type*				const_pointer;
+
+		typedef value_type&					reference;
+		typedef const value_type&				const_reference;
+
+	public:
+		// -----------
+		// operator ==
+		/**
+		 * Returns whether both deques hold equal elements in the same order
+		 */
+		friend bool operator == (const MyGapDeque& lhs, const MyGapDeque& rhs) {
+			return lhs.size() == rhs.size() and
+				std::equal(lhs.begin(), lhs.end(), rhs.begin() );}
+
+		// ----------
+		// operator <
+		/**
+		 * Returns whether lhs orders lexicographically before rhs
+		 */
+		friend bool operator < (const MyGapDeque& lhs, const MyGapDeque& rhs) {
+			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );}
+
+	private:
+		// ----
+		// data
+		allocator_type _a;
+
+		pointer _front;		// front of allocated space
+		pointer _begin;		// start of the prefix
+		pointer _gap;		// beginning of the gap (the cursor)
+		pointer _gap_end;	// end of the gap, start of the suffix
+		pointer _end;		// end of the suffix
+		pointer _back;		// back of allocated space
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return (!_front && !_begin && !_gap && !_gap_end && !_end && !_back) ||
+				((_front <= _begin) && (_begin <= _gap) && (_gap <= _gap_end) &&
+				 (_gap_end <= _end) && (_end <= _back));}
+
+	public:
+		// --------
+		// iterator
+		class iterator {
+			friend class MyGapDeque;
+
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag   	iterator_category;
+				typedef typename MyGapDeque::value_type	  	value_type;
+				typedef typename MyGapDeque::difference_type 	difference_type;
+				typedef typename MyGapDeque::pointer	  	pointer;
+				typedef typename MyGapDeque::reference	  	reference;
+				typedef typename MyGapDeque::size_type 	  	size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const iterator& lhs, const iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const iterator& lhs, const iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend iterator operator + (iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend iterator operator - (iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+			private:
+				// ----
+				// data
+				MyGapDeque* _d;
+				size_type idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns an iterator to the ith element of d
+				 */
+				iterator (MyGapDeque* d, size_type i = 0) :
+					_d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Provides access to the actual element
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ->
+				/**
+				 * Provides access to a member of the actual element
+				 */
+				pointer operator -> () const {
+					return &**this;}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				iterator operator ++ (int) {
+					iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				iterator operator -- (int) {
+					iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+	public:
+		// --------------
+		// const_iterator
+		class const_iterator {
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag   iterator_category;
+				typedef typename MyGapDeque::value_type	  value_type;
+				typedef typename MyGapDeque::difference_type difference_type;
+				typedef typename MyGapDeque::const_pointer   pointer;
+				typedef typename MyGapDeque::const_reference reference;
+				typedef typename MyGapDeque::size_type 	  size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend const_iterator operator + (const_iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend const_iterator operator - (const_iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+			private:
+				// ----
+				// data
+				const MyGapDeque*	_d;
+				size_type 		idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns a const_iterator to the ith element of d
+				 */
+				const_iterator (const MyGapDeque* d, size_type i)
+					: _d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Provides access to the actual element
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ->
+				/**
+				 * Provides access to a member of the actual element
+				 */
+				pointer operator -> () const {
+					return &**this;}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				const_iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				const_iterator operator ++ (int) {
+					const_iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				const_iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				const_iterator operator -- (int) {
+					const_iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				const_iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				const_iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+	public:
+		// ------------
+		// constructors
+		/**
+		 * Returns an empty gap deque with the specified allocator
+		 */
+		explicit MyGapDeque (const allocator_type& a = allocator_type() )
+			: _a(a), _front(0), _begin(0), _gap(0), _gap_end(0), _end(0), _back(0) {
+			assert(valid() );}
+
+		/**
+		 * Returns a gap deque with the specified size, values, and allocator
+		 * The cursor starts at the end
+		 */
+		explicit MyGapDeque (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type())
+			: _a(a), _front(0), _begin(0), _gap(0), _gap_end(0), _end(0), _back(0) {
+			if (s) {
+				_begin = _front = _a.allocate(s);
+				_gap = _gap_end = _end = _back = _front + s;
+				try {
+					uninitialized_fill(_a, _front, _back, v);}
+				catch (...) {
+					_a.deallocate(_front, s);
+					throw;}}
+			assert(valid() );}
+
+		/**
+		 * Returns a gap deque that is a copy of the specified gap deque
+		 * The copy is packed, with the cursor at the end
+		 */
+		MyGapDeque (const MyGapDeque& that)
+			: _a(that._a), _front(0), _begin(0), _gap(0), _gap_end(0), _end(0), _back(0) {
+			if (!that.empty()) {
+				_begin = _front = _a.allocate(that.size());
+				_gap = _gap_end = _end = _back = _front + that.size();
+				try {
+					uninitialized_copy(_a, that.begin(), that.end(), _front);}
+				catch (...) {
+					_a.deallocate(_front, that.size());
+					throw;}}
+			assert(valid() );}
+
+		// ----------
+		// destructor
+		/**
+		 * Destroys this gap deque
+		 */
+		~MyGapDeque () {
+			if (_front) {
+				clear_range();
+				_a.deallocate(_front, capacity());}
+			assert(valid() );}
+
+		// ----------
+		// operator =
+		/**
+		 * Returns a reference of this gap deque after copying the specified one
+		 */
+		MyGapDeque& operator = (const MyGapDeque& rhs) {
+			if (this != &rhs) {
+				MyGapDeque x(rhs);
+				swap(x);}
+			assert(valid() );
+			return *this;}
+
+		// -----------
+		// operator []
+		/**
+		 * Returns a reference to the nth element, skipping over the gap
+		 */
+		reference operator [] (size_type n) {
+			pointer r = _begin + n;
+			if (r >= _gap)
+				r += _gap_end - _gap;
+			return *r;}
+
+		/**
+		 * Returns a constant reference to the nth element
+		 */
+		const_reference operator [] (size_type n) const {
+			return const_cast<MyGapDeque*>(this)->operator[](n);}
+
+		// --
+		// at
+		/**
+		 * Returns a reference to the nth element
+		 * Throws an exception if n is out of bounds
+		 */
+		reference at (size_type n) {
+			if (n >= size() )
+				throw std::out_of_range("deque::_M_range_check");
+			return (*this)[n];}
+
+		/**
+		 * Returns a constant reference to the nth element
+		 * Throws an exception if n is out of bounds
+		 */
+		const_reference at (size_type n) const {
+			return const_cast<MyGapDeque*>(this)->at(n);}
+
+		// ----
+		// back
+		/**
+		 * Returns a reference of the element at the back
+		 */
+		reference back () {
+			assert(!empty() );
+			return (*this)[size() - 1];}
+
+		/**
+		 * Returns a constant reference of the element at the back
+		 */
+		const_reference back () const {
+			return const_cast<MyGapDeque*>(this)->back();}
+
+		// -----
+		// begin
+		/**
+		 * Returns an iterator for the first element
+		 */
+		iterator begin () {
+			return iterator(this, 0);}
+
+		/**
+		 * Returns a constant iterator for the first element
+		 */
+		const_iterator begin () const {
+			return const_iterator(this, 0);}
+
+		// --------
+		// capacity
+		/**
+		 * Returns the number of elements that fit without reallocating
+		 */
+		size_type capacity () const {
+			return _back - _front;}
+
+		// -----
+		// clear
+		/**
+		 * Removes all elements (empties the container)
+		 * The free space is split between the ends and the gap, as in layout.
+		 */
+		void clear () {
+			clear_range();
+			const size_type e = capacity() / 3;
+			_begin = _gap = _front + e;
+			_gap_end = _end = _back - e;
+			assert(valid() );}
+
+		// ------
+		// cursor
+		/**
+		 * Returns the index the gap currently sits in front of
+		 */
+		size_type cursor () const {
+			return _gap - _begin;}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the container is empty
+		 */
+		bool empty () const {
+			return !size();}
+
+		// ---
+		// end
+		/**
+		 * Returns an iterator to the position after the last element
+		 */
+		iterator end () {
+			return iterator(this, size() );}
+
+		/**
+		 * Returns a constant iterator to the position after the last element
+		 */
+		const_iterator end () const {
+			return const_iterator(this, size() );}
+
+		// -----
+		// erase
+		/**
+		 * Removes the element at iterator position pos and returns the position of the next element
+		 * The cursor is left at pos
+		 */
+		iterator erase (iterator pos) {
+			assert(pos.idx < size() );
+			move_cursor(pos.idx);
+			destroy(_a, _gap_end);
+			++_gap_end;
+			assert(valid() );
+			return pos;}
+
+		// -----
+		// front
+		/**
+		 * Returns the first element
+		 */
+		reference front () {
+			assert(!empty() );
+			return (*this)[0];}
+
+		/**
+		 * Returns the first element
+		 */
+		const_reference front () const {
+			return const_cast<MyGapDeque*>(this)->front();}
+
+		// ------
+		// insert
+		/**
+		 * Inserts a copy of v before iterator position pos and returns the position of the new element
+		 * The cursor is left just after the new element
+		 */
+		iterator insert (iterator pos, const_reference v) {
+			// v may live in this deque, and both growing and moving the cursor relocate elements
+			value_type x(v);
+			if (_gap == _gap_end)
+				make_room();
+			move_cursor(pos.idx);
+			construct(_a, _gap, x);
+			++_gap;
+			assert(valid() );
+			return pos;}
+
+		// -----------
+		// move_cursor
+		/**
+		 * Moves the gap in front of the ith element
+		 * Costs one relocation per element the gap passes over
+		 */
+		void move_cursor (size_type i) {
+			assert(i <= size() );
+			pointer p = _begin + i;
+			if (_gap == _gap_end)
+				_gap = _gap_end = p;
+			while (_gap > p) {
+				construct(_a, _gap_end - 1, *(_gap - 1) );
+				destroy(_a, _gap - 1);
+				--_gap;
+				--_gap_end;}
+			while (_gap < p) {
+				construct(_a, _gap, *_gap_end);
+				destroy(_a, _gap_end);
+				++_gap;
+				++_gap_end;}
+			assert(valid() );}
+
+		// --------
+		// pop_back
+		/**
+		 * Removes the last element (does not return it)
+		 * The cursor stays put, unless it was at the end.
+		 */
+		void pop_back () {
+			assert(!empty() );
+			if (_gap_end == _end) {
+				// the suffix is empty, so the last element ends the prefix
+				--_gap;
+				destroy(_a, _gap);}
+			else {
+				--_end;
+				destroy(_a, _end);}
+			assert(valid() );}
+
+		// ---------
+		// pop_front
+		/**
+		 * Removes the first element (does not return it)
+		 * The cursor stays in front of the same element, unless it was at
+		 * the beginning.
+		 */
+		void pop_front () {
+			assert(!empty() );
+			if (_begin == _gap) {
+				// the prefix is empty, so the first element starts the suffix
+				destroy(_a, _gap_end);
+				++_gap_end;}
+			else {
+				destroy(_a, _begin);
+				++_begin;}
+			assert(valid() );}
+
+		// ---------
+		// push_back
+		/**
+		 * Appends a copy of v at the end, leaving the cursor alone
+		 */
+		void push_back (const_reference v) {
+			if (_end == _back) {
+				// v may live in this deque, and make_room relocates it
+				value_type x(v);
+				make_room();
+				push_back(x);}
+			else {
+				construct(_a, _end, v);
+				++_end;}
+			assert(valid() );}
+
+		// ----------
+		// push_front
+		/**
+		 * Inserts a copy of v at the beginning
+		 * The cursor stays in front of the same element.
+		 */
+		void push_front (const_reference v) {
+			if (_begin == _front) {
+				value_type x(v);
+				make_room();
+				push_front(x);}
+			else {
+				construct(_a, _begin - 1, v);
+				--_begin;}
+			assert(valid() );}
+
+		// -------
+		// reserve
+		/**
+		 * Grows the allocation to hold at least c elements
+		 * The free space is split between the ends and the gap, as in layout.
+		 */
+		void reserve (size_type c) {
+			if (c > capacity() )
+				layout(c);}
+
+		// ------
+		// resize
+		/**
+		 * Changes the number of elements to s (if size() grows new elements are copies of v)
+		 * Elements are added or removed at the back, as by push_back and pop_back
+		 */
+		void resize (size_type s, const_reference v = value_type()) {
+			if (s == size() )
+				return;
+			if (s < size() )
+				while (size() != s)
+					pop_back();
+			else {
+				value_type x(v);
+				const size_type n = s - size();
+				if ((size_type)(_back - _end) < n)
+					// the back gets a third of the free space
+					layout(std::max(std::max(2 * size(), size() + 3 * n), capacity()) );
+				_end = uninitialized_fill(_a, _end, _end + n, x);}
+			assert(valid() );}
+
+		// ----
+		// size
+		/**
+		 * Returns the current number of elements
+		 */
+		size_type size () const {
+			return (_gap - _begin) + (_end - _gap_end);}
+
+		// ----
+		// swap
+		/**
+		 * Swaps the data of this with the data of that
+		 */
+		void swap (MyGapDeque& that) {
+			if (_a == that._a) {
+				std::swap(_front, that._front);
+				std::swap(_begin, that._begin);
+				std::swap(_gap, that._gap);
+				std::swap(_gap_end, that._gap_end);
+				std::swap(_end, that._end);
+				std::swap(_back, that._back);}
+			else {
+				MyGapDeque x(*this);
+				*this = that;
+				that = x;}
+			assert(valid() );}
+
+	private:
+		// -----------
+		// clear_range
+		/**
+		 * Destroys the prefix and the suffix without touching the allocation
+		 */
+		void clear_range () {
+			destroy(_a, _begin, _gap);
+			destroy(_a, _gap_end, _end);}
+
+		// ------
+		// layout
+		/**
+		 * Moves the elements into an allocation of c elements, the current
+		 * one if c is its capacity, keeping the cursor
+		 * A third of the free space goes to each end, and the rest to the gap.
+		 */
+		void layout (size_type c) {
+			const size_type p = _gap - _begin;
+			const size_type q = _end - _gap_end;
+			assert(p + q <= c);
+			const size_type e = (c - p - q) / 3;
+			if (c == capacity() ) {
+				pointer b = _front + e;
+				pointer s = _back - e - q;
+				// whichever half moves left goes first, so neither lands on the other
+				if (b <= _begin) {
+					relocate(_begin, p, b);
+					relocate(_gap_end, q, s);}
+				else {
+					relocate(_gap_end, q, s);
+					relocate(_begin, p, b);}
+				_begin = b;
+				_gap = b + p;
+				_gap_end = s;
+				_end = s + q;
+				assert(valid() );
+				return;}
+			pointer f = _a.allocate(c);
+			pointer b = f + e;
+			try {
+				uninitialized_copy(_a, _begin, _gap, b);
+				try {
+					uninitialized_copy(_a, _gap_end, _end, f + c - e - q);}
+				catch (...) {
+					destroy(_a, b, b + p);
+					throw;}}
+			catch (...) {
+				_a.deallocate(f, c);
+				throw;}
+			if (_front) {
+				clear_range();
+				_a.deallocate(_front, capacity() );}
+			_front = f;
+			_begin = b;
+			_gap = b + p;
+			_back = f + c;
+			_end = _back - e;
+			_gap_end = _end - q;
+			assert(valid() );}
+
+		// ---------
+		// make_room
+		/**
+		 * Makes free space at both ends and in the gap: in place if the
+		 * elements fill at most half the allocation, otherwise in a new one
+		 * twice their number
+		 */
+		void make_room () {
+			layout(std::max(std::max(2 * size(), capacity()), size_type(8)) );}
+
+		// --------
+		// relocate
+		/**
+		 * Moves the n elements at p to q, in the order that never overwrites
+		 * one not yet moved
+		 */
+		void relocate (pointer p, size_type n, pointer q) {
+			if (q < p)
+				for (size_type i = 0; i != n; ++i) {
+					construct(_a, q + i, p[i]);
+					destroy(_a, p + i);}
+			else if (p < q)
+				for (size_type i = n; i != 0; --i) {
+					construct(_a, q + i - 1, p[i - 1]);
+					destroy(_a, p + i - 1);}}};
+
+#endif // GapDeque_h
@@ -0,0 +1,739 @@
+// ------------------
+// IncrementalDeque.h
+// ------------------
+
+#ifndef IncrementalDeque_h
+#define IncrementalDeque_h
+
+// --------
+// includes
+#include <algorithm>	// equal, lexicographical_compare, swap
+#include <cassert>		// assert
+#include <iterator>		// bidirectional_iterator_tag
+#include <memory>		// allocator
+#include <stdexcept>	// out_of_range
+
+#include "Deque.h"		// construct, destroy, uninitialized_copy, uninitialized_fill
+
+// ------------------
+// MyIncrementalDeque
+/**
+ * A deque with MyDeque's one-buffer layout whose growth is spread over
+ * the operations that follow it instead of done all at once
+ * When an end runs out of room, a buffer of about twice the size is
+ * allocated and the elements are given slots in it, but they stay in the
+ * old buffer. Every later push and pop then moves up to step of them
+ * across, front first, and the old buffer is freed once it is empty.
+ * Until then operator[] looks pending slots up in the old buffer.
+ * So no push or pop relocates more than step elements besides the one it
+ * adds or removes, or makes more than one allocation and one deallocation.
+ */
+template < typename T, typename A = std::allocator<T> >
+class MyIncrementalDeque {
+	public:
+		// --------
+		// typedefs
+		typedef A						allocator_type;
+		typedef typename allocator_type::value_type		value_type;
+
+		typedef typename allocator_type::size_type		size_type;
+		typedef typename allocator_type::difference_type	difference_type;
+
+		typedef value_type*					pointer;
+		typedef const value_type*				const_pointer;
+
+		typedef value_type&					reference;
+		typedef const value_type&				const_reference;
+
+		// elements moved per push or pop while migrating; growth leaves more
+		// than size() / 2 free slots at each end, so 2 always finishes first
+		enum {step = 2};
+
+	public:
+		// -----------
+		// operator ==
+		/**
+		 * Returns whether both deques hold equal elements in the same order
+		 */
+		friend bool operator == (const MyIncrementalDeque& lhs, const MyIncrementalDeque& rhs) {
+			return lhs.size() == rhs.size() and
+				std::equal(lhs.begin(), lhs.end(), rhs.begin() );}
+
+		// ----------
+		// operator <
+		/**
+		 * Returns whether lhs orders lexicographically before rhs
+		 */
+		friend bool operator < (const MyIncrementalDeque& lhs, const MyIncrementalDeque& rhs) {
+			return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );}
+
+	private:
+		// ----
+		// data
+		allocator_type _a;
+
+		pointer _front;		// front of allocated space
+		pointer _begin;		// beginning of used slots
+		pointer _end;		// end of used slots
+		pointer _back;		// back of allocated space
+
+		pointer _old;		// previous buffer while migrating, else 0
+		size_type _old_size;	// its capacity
+		pointer _lo;		// first slot whose element is still in _old
+		pointer _hi;		// end of those slots
+		pointer _src;		// where the element for slot _lo lives in _old
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return ((!_front && !_begin && !_end && !_back) ||
+				((_front <= _begin) && (_begin <= _end) && (_end <= _back))) &&
+				(!_old || ((_begin <= _lo) && (_lo < _hi) && (_hi <= _end)));}
+
+	public:
+		// --------
+		// iterator
+		class iterator {
+			friend class MyIncrementalDeque;
+
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag   	iterator_category;
+				typedef typename MyIncrementalDeque::value_type	  	value_type;
+				typedef typename MyIncrementalDeque::difference_type 	difference_type;
+				typedef typename MyIncrementalDeque::pointer	  	pointer;
+				typedef typename MyIncrementalDeque::reference	  	reference;
+				typedef typename MyIncrementalDeque::size_type 	  	size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const iterator& lhs, const iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const iterator& lhs, const iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend iterator operator + (iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend iterator operator - (iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+			private:
+				// ----
+				// data
+				MyIncrementalDeque* _d;
+				size_type idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns an iterator to the ith element of d
+				 */
+				iterator (MyIncrementalDeque* d, size_type i = 0) :
+					_d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Provides access to the actual element
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ->
+				/**
+				 * Provides access to a member of the actual element
+				 */
+				pointer operator -> () const {
+					return &**this;}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				iterator operator ++ (int) {
+					iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				iterator operator -- (int) {
+					iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+	public:
+		// --------------
+		// const_iterator
+		class const_iterator {
+			public:
+				// --------
+				// typedefs
+				typedef std::bidirectional_iterator_tag   iterator_category;
+				typedef typename MyIncrementalDeque::value_type	  value_type;
+				typedef typename MyIncrementalDeque::difference_type difference_type;
+				typedef typename MyIncrementalDeque::const_pointer   pointer;
+				typedef typename MyIncrementalDeque::const_reference reference;
+				typedef typename MyIncrementalDeque::size_type 	  size_type;
+
+			public:
+				// -----------
+				// operator ==
+				/**
+				 * Returns whether two iterators are equal
+				 */
+				friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+					return lhs._d == rhs._d && lhs.idx == rhs.idx;}
+
+				/**
+				 * Returns whether two iterators are not equal
+				 */
+				friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+					return !(lhs == rhs);}
+
+				// ----------
+				// operator +
+				/**
+				 * Returns the iterator of the nth next element
+				 */
+				friend const_iterator operator + (const_iterator lhs, difference_type n) {
+					return lhs += n;}
+
+				// ----------
+				// operator -
+				/**
+				 * Returns the iterator of the nth previous element
+				 */
+				friend const_iterator operator - (const_iterator lhs, difference_type n) {
+					return lhs -= n;}
+
+			private:
+				// ----
+				// data
+				const MyIncrementalDeque*	_d;
+				size_type 		idx;
+
+			public:
+				// -----------
+				// constructor
+				/**
+				 * Returns a const_iterator to the ith element of d
+				 */
+				const_iterator (const MyIncrementalDeque* d, size_type i)
+					: _d(d), idx(i) {}
+
+				// ----------
+				// operator *
+				/**
+				 * Provides access to the actual element
+				 */
+				reference operator * () const {
+					return (*_d)[idx];}
+
+				// -----------
+				// operator ->
+				/**
+				 * Provides access to a member of the actual element
+				 */
+				pointer operator -> () const {
+					return &**this;}
+
+				// -----------
+				// operator ++
+				/**
+				 * Steps forward (returns new position)
+				 */
+				const_iterator& operator ++ () {
+					++idx;
+					return *this;}
+
+				/**
+				 * Steps forward (returns old position)
+				 */
+				const_iterator operator ++ (int) {
+					const_iterator x = *this;
+					++(*this);
+					return x;}
+
+				// -----------
+				// operator --
+				/**
+				 * Steps backward (returns new position)
+				 */
+				const_iterator& operator -- () {
+					--idx;
+					return *this;}
+
+				/**
+				 * Steps backward (returns old position)
+				 */
+				const_iterator operator -- (int) {
+					const_iterator x = *this;
+					--(*this);
+					return x;}
+
+				// -----------
+				// operator +=
+				/**
+				 * Steps n elements forward (or backward, if n is negative)
+				 */
+				const_iterator& operator += (difference_type n) {
+					idx += n;
+					return *this;}
+
+				// -----------
+				// operator -=
+				/**
+				 * Steps n elements backward (or forward, if n is negative)
+				 */
+				const_iterator& operator -= (difference_type n) {
+					idx -= n;
+					return *this;}};
+
+	public:
+		// ------------
+		// constructors
+		/**
+		 * Returns an empty deque with the specified allocator
+		 */
+		explicit MyIncrementalDeque (const allocator_type& a = allocator_type() )
+			: _a(a), _front(0), _begin(0), _end(0), _back(0), _old(0), _old_size(0), _lo(0), _hi(0), _src(0) {
+			assert(valid() );}
+
+		/**
+		 * Returns a deque with the specified size, values, and allocator
+		 */
+		explicit MyIncrementalDeque (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type())
+			: _a(a), _front(0), _begin(0), _end(0), _back(0), _old(0), _old_size(0), _lo(0), _hi(0), _src(0) {
+			if (s) {
+				_front = _begin = _a.allocate(s);
+				_end = _back = _front + s;
+				try {
+					uninitialized_fill(_a, _front, _back, v);}
+				catch (...) {
+					_a.deallocate(_front, s);
+					throw;}}
+			assert(valid() );}
+
+		/**
+		 * Returns a deque that is a copy of the specified deque
+		 * The copy is packed and not migrating
+		 */
+		MyIncrementalDeque (const MyIncrementalDeque& that)
+			: _a(that._a), _front(0), _begin(0), _end(0), _back(0), _old(0), _old_size(0), _lo(0), _hi(0), _src(0) {
+			if (!that.empty()) {
+				_front = _begin = _a.allocate(that.size());
+				_end = _back = _front + that.size();
+				try {
+					uninitialized_copy(_a, that.begin(), that.end(), _front);}
+				catch (...) {
+					_a.deallocate(_front, that.size());
+					throw;}}
+			assert(valid() );}
+
+		// ----------
+		// destructor
+		/**
+		 * Destroys this deque
+		 */
+		~MyIncrementalDeque () {
+			clear();
+			if (_front)
+				_a.deallocate(_front, _back - _front);}
+
+		// ----------
+		// operator =
+		/**
+		 * Returns a reference of this deque after copying the specified one
+		 */
+		MyIncrementalDeque& operator = (const MyIncrementalDeque& rhs) {
+			if (this != &rhs) {
+				MyIncrementalDeque x(rhs);
+				swap(x);}
+			assert(valid() );
+			return *this;}
+
+		// -----------
+		// operator []
+		/**
+		 * Returns a reference to the nth element, wherever it lives
+		 */
+		reference operator [] (size_type n) {
+			pointer p = _begin + n;
+			if (_old && _lo <= p && p < _hi)
+				return *(_src + (p - _lo));
+			return *p;}
+
+		/**
+		 * Returns a constant reference to the nth element
+		 */
+		const_reference operator [] (size_type n) const {
+			return const_cast<MyIncrementalDeque*>(this)->operator[](n);}
+
+		// --
+		// at
+		/**
+		 * Returns a reference to the nth element
+		 * Throws an exception if n is out of bounds
+		 */
+		reference at (size_type n) {
+			if (n >= size() )
+				throw std::out_of_range("deque::_M_range_check");
+			return (*this)[n];}
+
+		/**
+		 * Returns a constant reference to the nth element
+		 * Throws an exception if n is out of bounds
+		 */
+		const_reference at (size_type n) const {
+			return const_cast<MyIncrementalDeque*>(this)->at(n);}
+
+		// ----
+		// back
+		/**
+		 * Returns a reference of the element at the back
+		 */
+		reference back () {
+			assert(!empty() );
+			return (*this)[size() - 1];}
+
+		/**
+		 * Returns a constant reference of the element at the back
+		 */
+		const_reference back () const {
+			return const_cast<MyIncrementalDeque*>(this)->back();}
+
+		// -----
+		// begin
+		/**
+		 * Returns an iterator for the first element
+		 */
+		iterator begin () {
+			return iterator(this, 0);}
+
+		/**
+		 * Returns a constant iterator for the first element
+		 */
+		const_iterator begin () const {
+			return const_iterator(this, 0);}
+
+		// -----
+		// clear
+		/**
+		 * Removes all elements (empties the container) and drops the old buffer
+		 */
+		void clear () {
+			if (_old) {
+				destroy(_a, _begin, _lo);
+				destroy(_a, _src, _src + (_hi - _lo));
+				destroy(_a, _hi, _end);
+				release();}
+			else
+				destroy(_a, _begin, _end);
+			_end = _begin;
+			assert(valid() );}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the container is empty
+		 */
+		bool empty () const {
+			return !size();}
+
+		// ---
+		// end
+		/**
+		 * Returns an iterator to the position after the last element
+		 */
+		iterator end () {
+			return iterator(this, size() );}
+
+		/**
+		 * Returns a constant iterator to the position after the last element
+		 */
+		const_iterator end () const {
+			return const_iterator(this, size() );}
+
+		// -----
+		// erase
+		/**
+		 * Removes the element at iterator position pos and returns the position of the next element
+		 * Shifts the elements after pos down by assignment
+		 */
+		iterator erase (iterator pos) {
+			assert(pos.idx < size() );
+			for (size_type i = pos.idx; i + 1 < size(); ++i)
+				(*this)[i] = (*this)[i + 1];
+			pop_back();
+			assert(valid() );
+			return pos;}
+
+		// -----
+		// front
+		/**
+		 * Returns the first element
+		 */
+		reference front () {
+			assert(!empty() );
+			return (*this)[0];}
+
+		/**
+		 * Returns the first element
+		 */
+		const_reference front () const {
+			return const_cast<MyIncrementalDeque*>(this)->front();}
+
+		// ------
+		// insert
+		/**
+		 * Inserts a copy of v before iterator position pos and returns the position of the new element
+		 * Shifts the elements from pos up by assignment
+		 */
+		iterator insert (iterator pos, const_reference v) {
+			assert(pos.idx <= size() );
+			// v may live in this deque, and pushing may move it
+			value_type x(v);
+			push_back(x);
+			for (size_type i = size() - 1; i > pos.idx; --i)
+				(*this)[i] = (*this)[i - 1];
+			(*this)[pos.idx] = x;
+			assert(valid() );
+			return pos;}
+
+		// -------
+		// pending
+		/**
+		 * Returns how many elements still live in the old buffer
+		 */
+		size_type pending () const {
+			return _old ? _hi - _lo : 0;}
+
+		// --------
+		// pop_back
+		/**
+		 * Removes the last element (does not return it)
+		 */
+		void pop_back () {
+			assert(!empty() );
+			if (_old && _hi == _end) {
+				--_hi;
+				destroy(_a, _src + (_hi - _lo));
+				if (_lo == _hi)
+					release();}
+			else
+				destroy(_a, _end - 1);
+			--_end;
+			migrate();
+			assert(valid() );}
+
+		// ---------
+		// pop_front
+		/**
+		 * Removes the first element (does not return it)
+		 */
+		void pop_front () {
+			assert(!empty() );
+			if (_old && _lo == _begin) {
+				destroy(_a, _src);
+				++_src;
+				++_lo;
+				if (_lo == _hi)
+					release();}
+			else
+				destroy(_a, _begin);
+			++_begin;
+			migrate();
+			assert(valid() );}
+
+		// ---------
+		// push_back
+		/**
+		 * Appends a copy of v at the end
+		 */
+		void push_back (const_reference v) {
+			if (_end == _back) {
+				// v may live in this deque, and growing may move it
+				value_type x(v);
+				grow();
+				push_back(x);
+				return;}
+			migrate();
+			construct(_a, _end, v);
+			++_end;
+			assert(valid() );}
+
+		// ----------
+		// push_front
+		/**
+		 * Inserts a copy of v at the beginning
+		 */
+		void push_front (const_reference v) {
+			if (_front == _begin) {
+				value_type x(v);
+				grow();
+				push_front(x);
+				return;}
+			migrate();
+			construct(_a, _begin - 1, v);
+			--_begin;
+			assert(valid() );}
+
+		// ------
+		// resize
+		/**
+		 * Changes the number of elements to s (if size() grows new elements are copies of v)
+		 * One push_back or pop_back per element, so each step keeps their bound
+		 */
+		void resize (size_type s, const_reference v = value_type()) {
+			value_type x(v);
+			while (size() > s)
+				pop_back();
+			while (size() < s)
+				push_back(x);
+			assert(valid() );}
+
+		// ----
+		// size
+		/**
+		 * Returns the current number of elements
+		 */
+		size_type size () const {
+			return _end - _begin;}
+
+		// ----
+		// swap
+		/**
+		 * Swaps the data of this with the data of that
+		 */
+		void swap (MyIncrementalDeque& that) {
+			if (_a == that._a) {
+				std::swap(_front, that._front);
+				std::swap(_begin, that._begin);
+				std::swap(_end, that._end);
+				std::swap(_back, that._back);
+				std::swap(_old, that._old);
+				std::swap(_old_size, that._old_size);
+				std::swap(_lo, that._lo);
+				std::swap(_hi, that._hi);
+				std::swap(_src, that._src);}
+			else {
+				MyIncrementalDeque x(*this);
+				*this = that;
+				that = x;}
+			assert(valid() );}
+
+	private:
+		// ----
+		// grow
+		/**
+		 * Moves to a new buffer of 2 * size() + 4 slots with the elements
+		 * centered in it, leaving every element in the old buffer
+		 * Costs one allocation and no copies
+		 */
+		void grow () {
+			// never taken: step finishes a migration before either end fills
+			while (_old)
+				migrate();
+			const size_type n = size();
+			const size_type c = 2 * n + 4;
+			pointer f = _a.allocate(c);
+			pointer b = f + (c - n) / 2;
+			if (n) {
+				_old = _front;
+				_old_size = _back - _front;
+				_src = _begin;
+				_lo = b;
+				_hi = b + n;}
+			else if (_front)
+				_a.deallocate(_front, _back - _front);
+			_front = f;
+			_begin = b;
+			_end = b + n;
+			_back = f + c;
+			assert(valid() );}
+
+		// -------
+		// migrate
+		/**
+		 * Moves up to step pending elements from the old buffer to their slots
+		 */
+		void migrate () {
+			for (int i = 0; _old && i != step; ++i) {
+				construct(_a, _lo, *_src);
+				destroy(_a, _src);
+				++_src;
+				++_lo;
+				if (_lo == _hi)
+					release();}}
+
+		// -------
+		// release
+		/**
+		 * Frees the old buffer once nothing in it is pending
+		 */
+		void release () {
+			_a.deallocate(_old, _old_size);
+			_old = _lo = _hi = _src = 0;
+			_old_size = 0;}};
+
+#endif // IncrementalDeque_h
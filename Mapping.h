@@ -0,0 +1,190 @@
+// ---------
+// Mapping.h
+// ---------
+
+#ifndef Mapping_h
+#define Mapping_h
+
+// --------
+// includes
+#include <cassert>		// assert
+#include <cstddef>		// size_t
+#include <cstring>		// memcpy
+#include <memory>		// allocator
+#include <new>			// bad_alloc
+
+#ifdef __linux__
+#include <sys/mman.h>	// mmap, mremap, munmap
+#include <unistd.h>		// sysconf
+#endif
+
+#if __cplusplus >= 201103L
+#include <type_traits>	// is_trivially_copyable
+#endif
+
+// -----------
+// is_mappable
+/**
+ * Whether a T can be relocated by moving its bytes
+ * C++98 cannot ask, so there only the built-in types and pointers qualify.
+ */
+#if __cplusplus >= 201103L
+template <typename T>
+struct is_mappable {
+	enum {value = std::is_trivially_copyable<T>::value};};
+#else
+template <typename T>
+struct is_mappable {
+	enum {value = false};};
+
+template <typename T>
+struct is_mappable<T*> {
+	enum {value = true};};
+
+#define MY_MAPPABLE(T)					\
+	template <>						\
+	struct is_mappable<T> {				\
+		enum {value = true};};
+MY_MAPPABLE(bool)
+MY_MAPPABLE(char)
+MY_MAPPABLE(signed char)
+MY_MAPPABLE(unsigned char)
+MY_MAPPABLE(wchar_t)
+MY_MAPPABLE(short)
+MY_MAPPABLE(unsigned short)
+MY_MAPPABLE(int)
+MY_MAPPABLE(unsigned int)
+MY_MAPPABLE(long)
+MY_MAPPABLE(unsigned long)
+MY_MAPPABLE(float)
+MY_MAPPABLE(double)
+MY_MAPPABLE(long double)
+#undef MY_MAPPABLE
+#endif
+
+// --------------------
+// is_default_allocator
+template <typename T, typename A>
+struct is_default_allocator {
+	enum {value = false};};
+
+template <typename T>
+struct is_default_allocator<T, std::allocator<T> > {
+	enum {value = true};};
+
+// --------------
+// MyMappingTally
+/**
+ * How many times growing a buffer remapped it, and how many bytes
+ * growing buffers copied instead, so tests can tell which happened
+ */
+struct MyMappingTally {
+	std::size_t remaps;
+	std::size_t copied;
+
+	static MyMappingTally& get () {
+		static MyMappingTally t = {0, 0};
+		return t;}};
+
+// ---------
+// MyMapping
+/**
+ * Where MyDeque and my_vector get their buffers
+ * Buffers of at least threshold bytes of a mappable T in the default
+ * allocator's care are anonymous memory mappings instead, which
+ * reallocate grows with mremap: the kernel moves page table entries,
+ * not bytes, so growing costs the pages remapped rather than the bytes
+ * copied. Any other allocator is used as is, since its memory may have
+ * to live somewhere in particular. Whether a buffer is mapped follows
+ * from its size, so callers pass the same size to deallocate as they
+ * got from allocate.
+ * mremap is Linux's own, so elsewhere nothing is mapped and every
+ * buffer comes from the allocator, grown by allocating and copying.
+ */
+template <typename T, typename A>
+struct MyMapping {
+#ifdef __linux__
+	enum {enabled = is_default_allocator<T, A>::value && is_mappable<T>::value};
+#else
+	enum {enabled = false};
+#endif
+	enum {threshold = 1 << 20};
+
+	// ------
+	// mapped
+	/**
+	 * Returns whether a buffer of n Ts is a mapping
+	 */
+	static bool mapped (std::size_t n) {
+		return enabled && n * sizeof(T) >= threshold;}
+
+	// --------
+	// allocate
+	/**
+	 * Returns a buffer of n Ts
+	 * Throws bad_alloc if there is no memory
+	 */
+	static T* allocate (A& a, std::size_t n) {
+#ifdef __linux__
+		if (mapped(n)) {
+			void* p = mmap(0, bytes(n), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (p == MAP_FAILED)
+				throw std::bad_alloc();
+			return static_cast<T*>(p);}
+#endif
+		return a.allocate(n);}
+
+	// ----------
+	// deallocate
+	/**
+	 * Releases a buffer of n Ts from allocate
+	 */
+	static void deallocate (A& a, T* p, std::size_t n) {
+#ifdef __linux__
+		if (mapped(n)) {
+			munmap(p, bytes(n));
+			return;}
+#endif
+		a.deallocate(p, n);}
+
+	// ----------
+	// reallocate
+	/**
+	 * Returns a buffer of m Ts that starts with the bytes of [p, p + n),
+	 * which it releases; p may be 0 if n is
+	 * Two mappings are joined with mremap, which may move the pages but
+	 * never their contents; otherwise the bytes are copied once.
+	 * Throws bad_alloc, keeping p, if there is no memory
+	 */
+	static T* reallocate (A& a, T* p, std::size_t n, std::size_t m) {
+		assert(enabled && n <= m);
+#ifdef __linux__
+		if (mapped(n)) {
+			void* q = mremap(p, bytes(n), bytes(m), MREMAP_MAYMOVE);
+			if (q == MAP_FAILED)
+				throw std::bad_alloc();
+			++MyMappingTally::get().remaps;
+			return static_cast<T*>(q);}
+#endif
+		T* q = allocate(a, m);
+		if (p) {
+			std::memcpy(static_cast<void*>(q), p, n * sizeof(T));
+			MyMappingTally::get().copied += n * sizeof(T);
+			deallocate(a, p, n);}
+		return q;}
+
+	private:
+		// -----
+		// bytes
+		/**
+		 * Returns n Ts in bytes, rounded up to whole pages
+		 */
+		static std::size_t bytes (std::size_t n) {
+#ifdef __linux__
+			static const std::size_t page = sysconf(_SC_PAGESIZE);
+#else
+			const std::size_t page = 4096;
+#endif
+			return (n * sizeof(T) + page - 1) / page * page;}};
+
+#endif // Mapping_h
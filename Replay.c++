@@ -0,0 +1,155 @@
+// ----------
+// Replay.c++
+// ----------
+
+/*
+To record the sample workload and replay it:
+	% g++ -ansi -pedantic -Wall -O2 -DNDEBUG -DDEQUE_TRACE Replay.c++ -o Record.app
+	% g++ -ansi -pedantic -Wall -O2 -DNDEBUG Replay.c++ -o Replay.c++.app
+	% Record.app sample.trace
+	% Replay.c++.app sample.trace
+
+Built with -DDEQUE_TRACE this records instead of replaying: the hooks cost
+MyDeque time even when no trace is being recorded, so the replay has to be
+built without them. Any program compiled with -DDEQUE_TRACE records its own
+trace between MyTrace::start(path) and MyTrace::stop().
+*/
+
+// --------
+// includes
+#include <cstdio>     // printf
+#include <cstdlib>    // rand, srand
+#include <deque>      // deque
+#include <memory>     // allocator
+#include <vector>     // vector
+#include <time.h>     // clock_gettime, CLOCK_MONOTONIC
+
+#include "Deque.h"
+#include "GapDeque.h"
+#include "IncrementalDeque.h"
+#include "Trace.h"
+
+// -----
+// usage
+/**
+ * Allocator activity of the replay in progress
+ */
+struct usage {
+	static long allocations;
+	static long bytes;		// allocated and not yet deallocated
+	static long peak;
+
+	static void reset () {
+		allocations = bytes = peak = 0;}};
+
+long usage::allocations;
+long usage::bytes;
+long usage::peak;
+
+// ---------------
+// ReplayAllocator
+/**
+ * A std::allocator that reports to usage
+ */
+template <typename T>
+struct ReplayAllocator : std::allocator<T> {
+	typedef std::allocator<T>		base;
+	typedef typename base::size_type	size_type;
+	typedef T*				pointer;
+
+	template <typename U>
+	struct rebind {
+		typedef ReplayAllocator<U> other;};
+
+	ReplayAllocator () {}
+
+	template <typename U>
+	ReplayAllocator (const ReplayAllocator<U>&) {}
+
+	pointer allocate (size_type n, const void* = 0) {
+		++usage::allocations;
+		usage::bytes += n * sizeof(T);
+		if (usage::bytes > usage::peak)
+			usage::peak = usage::bytes;
+		return base::allocate(n);}
+
+	void deallocate (pointer p, size_type n) {
+		usage::bytes -= n * sizeof(T);
+		base::deallocate(p, n);}};
+
+// ---
+// now
+long now () {
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1000000000L + t.tv_nsec;}
+
+// ------
+// report
+/**
+ * Replays rs on C and prints its time, allocations and peak memory
+ */
+template <typename C>
+void report (const char* name, const std::vector<MyTrace::record>& rs) {
+	usage::reset();
+	const long t = now();
+	const long sink = MyTrace::replay<C>(rs);
+	const long ns = now() - t;
+	std::printf("%-14s %12.3f %14ld %14ld %14ld\n",
+		name, ns / 1e6, usage::allocations, usage::peak, sink);}
+
+#ifdef DEQUE_TRACE
+// ------
+// sample
+/**
+ * Records a mix of queue, random access and editing traffic
+ */
+void sample () {
+	std::srand(0);
+	MyDeque<int> q;
+	for (int i = 0; i != 1000000; ++i) {
+		q.push_back(i);
+		if (q.size() > 4096)
+			q.pop_front();
+		if (i % 4 == 0)
+			q[std::rand() % q.size()] += 1;
+		if (i % 4096 == 0) {
+			MyDeque<int> s(q);
+			s.insert(s.begin() + s.size() / 2, i);
+			s.erase(s.begin());
+			s.resize(s.size() / 2);
+			q.swap(s);}}}
+#endif
+
+// ----
+// main
+#ifdef DEQUE_TRACE
+int main (int argc, char* argv[]) {
+	if (argc != 2) {
+		std::printf("usage: %s trace\n", argv[0]);
+		return 1;}
+	if (!MyTrace::start(argv[1])) {
+		std::printf("cannot write %s\n", argv[1]);
+		return 1;}
+	sample();
+	std::printf("%lu records written to %s\n", MyTrace::stop(), argv[1]);
+	return 0;}
+#else
+int main (int argc, char* argv[]) {
+	if (argc != 2) {
+		std::printf("usage: %s trace\n", argv[0]);
+		return 1;}
+
+	std::vector<MyTrace::record> rs;
+	if (!MyTrace::read(argv[1], rs)) {
+		std::printf("%s is not a trace\n", argv[1]);
+		return 1;}
+
+	std::printf("%lu records\n\n", (unsigned long)rs.size());
+	std::printf("%-14s %12s %14s %14s %14s\n", "", "time (ms)", "allocations", "peak (bytes)", "checksum");
+	report< MyDeque<int, ReplayAllocator<int> > >("MyDeque", rs);
+	report< std::deque<int, ReplayAllocator<int> > >("std::deque", rs);
+	report< MyGapDeque<int, ReplayAllocator<int> > >("MyGapDeque", rs);
+	report< MyIncrementalDeque<int, ReplayAllocator<int> > >("Incremental", rs);
+	return 0;}
+#endif
@@ -0,0 +1,820 @@
+// -------------
+// SharedDeque.h
+// -------------
+
+#ifndef SharedDeque_h
+#define SharedDeque_h
+
+// --------
+// includes
+#include <algorithm>	// max
+#include <cassert>		// assert
+#include <cerrno>		// errno, EOWNERDEAD
+#include <cstddef>		// ptrdiff_t, size_t
+#include <cstring>		// strerror
+#include <new>			// bad_alloc, placement new
+#include <stdexcept>	// runtime_error
+#include <string>		// string
+
+#include <fcntl.h>		// O_CREAT, O_EXCL, O_RDWR
+#include <pthread.h>	// pthread_cond_t, pthread_mutex_t
+#include <sys/mman.h>	// mmap, munmap, shm_open, shm_unlink
+#include <sys/stat.h>	// fstat
+#include <unistd.h>		// close, ftruncate
+
+#include "Deque.h"		// construct, destroy, uninitialized_copy
+
+// -----------
+// MyOffsetPtr
+/**
+ * A pointer stored as the distance from its own address to its target,
+ * so a structure of them stays valid wherever its memory is mapped
+ * Copying recomputes the distance for the copy's address. A null pointer
+ * is stored as 1, which would put the target inside the MyOffsetPtr's
+ * own bytes, where no T can start; 0 stays free for a pointer to its own
+ * address, such as a one-node ring whose link is the node's first member.
+ */
+template <typename T>
+class MyOffsetPtr {
+	private:
+		// ----
+		// data
+		std::ptrdiff_t _off;	// bytes from this to the target, null for null
+
+		enum {null = 1};
+
+	private:
+		// ---
+		// set
+		void set (const T* p) {
+			_off = p ? reinterpret_cast<const char*>(p) - reinterpret_cast<const char*>(this) : null;}
+
+	public:
+		// ------------
+		// constructors
+		/**
+		 * Returns a pointer to p
+		 */
+		MyOffsetPtr (T* p = 0) {
+			set(p);}
+
+		/**
+		 * Returns a pointer to that's target
+		 */
+		MyOffsetPtr (const MyOffsetPtr& that) {
+			set(that.get());}
+
+		// ----------
+		// operator =
+		/**
+		 * Points at that's target
+		 */
+		MyOffsetPtr& operator = (const MyOffsetPtr& that) {
+			set(that.get());
+			return *this;}
+
+		/**
+		 * Points at p
+		 */
+		MyOffsetPtr& operator = (T* p) {
+			set(p);
+			return *this;}
+
+		// ---
+		// get
+		/**
+		 * Returns the target as a raw pointer for this process
+		 */
+		T* get () const {
+			if (_off == null)
+				return 0;
+			return reinterpret_cast<T*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + _off);}
+
+		/**
+		 * Converts to a raw pointer, so arithmetic and comparisons work as on T*
+		 */
+		operator T* () const {
+			return get();}
+
+		T* operator -> () const {
+			return get();}
+
+		MyOffsetPtr& operator ++ () {
+			_off += sizeof(T);
+			return *this;}
+
+		MyOffsetPtr& operator -- () {
+			_off -= sizeof(T);
+			return *this;}};
+
+// ------------
+// MySharedLock
+/**
+ * Scoped lock on a process-shared mutex
+ * The mutexes are robust: if a process dies holding one, the next locker
+ * is handed the lock and marks it consistent instead of hanging forever.
+ * Whatever operation the dead process was in the middle of stays half
+ * done, so a crashed peer is a reason to stop using the segment soon.
+ */
+class MySharedLock {
+	private:
+		// ----
+		// data
+		pthread_mutex_t* _m;
+
+	private:
+		MySharedLock (const MySharedLock&);
+		MySharedLock& operator = (const MySharedLock&);
+
+		// -----
+		// check
+		static void check (pthread_mutex_t* m, int r) {
+			if (r == EOWNERDEAD)
+				pthread_mutex_consistent(m);
+			else if (r)
+				throw std::runtime_error(std::string("pthread_mutex_lock: ") + std::strerror(r));}
+
+	public:
+		// ----
+		// init
+		/**
+		 * Initializes a robust mutex usable from any process that maps it
+		 */
+		static void init (pthread_mutex_t* m) {
+			pthread_mutexattr_t a;
+			pthread_mutexattr_init(&a);
+			pthread_mutexattr_setpshared(&a, PTHREAD_PROCESS_SHARED);
+			pthread_mutexattr_setrobust(&a, PTHREAD_MUTEX_ROBUST);
+			const int r = pthread_mutex_init(m, &a);
+			pthread_mutexattr_destroy(&a);
+			if (r)
+				throw std::runtime_error(std::string("pthread_mutex_init: ") + std::strerror(r));}
+
+		/**
+		 * Initializes a condition variable usable from any process that maps it
+		 */
+		static void init (pthread_cond_t* c) {
+			pthread_condattr_t a;
+			pthread_condattr_init(&a);
+			pthread_condattr_setpshared(&a, PTHREAD_PROCESS_SHARED);
+			const int r = pthread_cond_init(c, &a);
+			pthread_condattr_destroy(&a);
+			if (r)
+				throw std::runtime_error(std::string("pthread_cond_init: ") + std::strerror(r));}
+
+		// -----------
+		// constructor
+		/**
+		 * Locks m
+		 */
+		explicit MySharedLock (pthread_mutex_t* m) :
+			_m(m) {
+			check(_m, pthread_mutex_lock(_m));}
+
+		// ----------
+		// destructor
+		/**
+		 * Unlocks the mutex
+		 */
+		~MySharedLock () {
+			pthread_mutex_unlock(_m);}
+
+		// ----
+		// wait
+		/**
+		 * Unlocks the mutex until c is signalled, then locks it again
+		 */
+		void wait (pthread_cond_t* c) {
+			check(_m, pthread_cond_wait(c, _m));}};
+
+// -------------
+// MySharedArena
+/**
+ * A first-fit heap laid over a block of shared memory, starting at its own
+ * address
+ * Free blocks form a list in address order, linked by offset pointers,
+ * and freeing a block merges it with free neighbours. The arena also keeps
+ * one root pointer, so a process that maps the memory later can find the
+ * object the creator put there.
+ */
+class MySharedArena {
+	public:
+		// --------
+		// typedefs
+		typedef std::size_t size_type;
+
+	private:
+		// -----
+		// block
+		struct block {
+			size_type			size;	// bytes, header included
+			MyOffsetPtr<block>	next;	// next free block by address, only while free
+		};
+
+		// -----
+		// align
+		static size_type align (size_type n) {
+			const size_type a = 16;
+			return (n + a - 1) / a * a;}
+
+		// ------
+		// header
+		static size_type header () {
+			return align(sizeof(block));}
+
+	private:
+		// ----
+		// data
+		size_type _size;			// bytes in the free list when empty
+		pthread_mutex_t _m;
+		MyOffsetPtr<char> _root;
+		MyOffsetPtr<block> _free;	// lowest free block
+
+	private:
+		MySharedArena (const MySharedArena&);
+		MySharedArena& operator = (const MySharedArena&);
+
+	public:
+		// -----------
+		// constructor
+		/**
+		 * Lays out an arena over the n bytes starting at this
+		 */
+		explicit MySharedArena (size_type n) :
+				_size(0) {
+			if (n < align(sizeof(MySharedArena)) + 2 * header())
+				throw std::bad_alloc();
+			MySharedLock::init(&_m);
+			block* b = new (reinterpret_cast<char*>(this) + align(sizeof(MySharedArena))) block;
+			b->size = (n - align(sizeof(MySharedArena))) / 16 * 16;
+			_size = b->size;
+			_free = b;}
+
+		// ----------
+		// destructor
+		~MySharedArena () {
+			pthread_mutex_destroy(&_m);}
+
+		// --------
+		// allocate
+		/**
+		 * Returns n bytes aligned to 16, from the lowest free block that fits
+		 * Throws bad_alloc if none does
+		 */
+		void* allocate (size_type n) {
+			const size_type s = header() + align(n);
+			MySharedLock l(&_m);
+			MyOffsetPtr<block>* link = &_free;
+			for (block* b = _free; b; link = &b->next, b = b->next) {
+				if (b->size < s)
+					continue;
+				if (b->size - s >= 2 * header()) {
+					block* r = new (reinterpret_cast<char*>(b) + s) block;
+					r->size = b->size - s;
+					r->next = b->next;
+					b->size = s;
+					*link = r;}
+				else
+					*link = b->next;
+				return reinterpret_cast<char*>(b) + header();}
+			throw std::bad_alloc();}
+
+		// ---------
+		// available
+		/**
+		 * Returns the bytes in free blocks, headers included
+		 */
+		size_type available () const {
+			MySharedLock l(const_cast<pthread_mutex_t*>(&_m));
+			size_type n = 0;
+			for (const block* b = _free; b; b = b->next)
+				n += b->size;
+			return n;}
+
+		// --------
+		// capacity
+		/**
+		 * Returns the bytes in free blocks while nothing is allocated
+		 */
+		size_type capacity () const {
+			return _size;}
+
+		// ----------
+		// deallocate
+		/**
+		 * Returns p, from allocate(), to the free list
+		 */
+		void deallocate (void* p) {
+			if (!p)
+				return;
+			block* b = reinterpret_cast<block*>(static_cast<char*>(p) - header());
+			MySharedLock l(&_m);
+			block* prev = 0;
+			block* next = _free;
+			while (next && next < b) {
+				prev = next;
+				next = next->next;}
+			b->next = next;
+			if (prev)
+				prev->next = b;
+			else
+				_free = b;
+			if (next && reinterpret_cast<char*>(b) + b->size == reinterpret_cast<char*>(next)) {
+				b->size += next->size;
+				b->next = next->next;}
+			if (prev && reinterpret_cast<char*>(prev) + prev->size == reinterpret_cast<char*>(b)) {
+				prev->size += b->size;
+				prev->next = b->next;}}
+
+		// ----
+		// root
+		/**
+		 * Returns the root object, or 0 if none was set
+		 */
+		void* root () const {
+			return _root.get();}
+
+		/**
+		 * Sets the root object
+		 */
+		void root (void* p) {
+			_root = static_cast<char*>(p);}};
+
+// --------------
+// MySharedMemory
+/**
+ * A mapping of a named POSIX shared-memory segment with a MySharedArena
+ * at its start
+ * Each process maps the segment wherever mmap puts it, so everything
+ * stored in it has to address the segment through offsets.
+ */
+class MySharedMemory {
+	public:
+		// --------
+		// typedefs
+		typedef std::size_t size_type;
+
+	private:
+		// ----
+		// data
+		char* _p;
+		size_type _n;
+
+	private:
+		MySharedMemory (const MySharedMemory&);
+		MySharedMemory& operator = (const MySharedMemory&);
+
+		// ----
+		// fail
+		static void fail (const char* what) {
+			throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));}
+
+		// ---
+		// map
+		void map (int fd) {
+			void* p = mmap(0, _n, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (p == MAP_FAILED) {
+				close(fd);
+				fail("mmap");}
+			close(fd);
+			_p = static_cast<char*>(p);}
+
+	public:
+		// ------------
+		// constructors
+		/**
+		 * Creates the segment name with n bytes and lays out an arena in it
+		 * Throws if the segment already exists
+		 */
+		MySharedMemory (const char* name, size_type n) :
+				_p(0), _n(n) {
+			const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+			if (fd == -1)
+				fail("shm_open");
+			if (ftruncate(fd, n) == -1) {
+				close(fd);
+				shm_unlink(name);
+				fail("ftruncate");}
+			try {
+				map(fd);
+				new (_p) MySharedArena(n);}
+			catch (...) {
+				if (_p)
+					munmap(_p, _n);
+				shm_unlink(name);
+				throw;}}
+
+		/**
+		 * Maps the existing segment name
+		 */
+		explicit MySharedMemory (const char* name) :
+				_p(0), _n(0) {
+			const int fd = shm_open(name, O_RDWR, 0);
+			if (fd == -1)
+				fail("shm_open");
+			struct stat s;
+			if (fstat(fd, &s) == -1) {
+				close(fd);
+				fail("fstat");}
+			_n = s.st_size;
+			map(fd);}
+
+		// ----------
+		// destructor
+		/**
+		 * Unmaps the segment; it lives on until remove() and the last unmap
+		 */
+		~MySharedMemory () {
+			munmap(_p, _n);}
+
+		// -----
+		// arena
+		/**
+		 * Returns the arena at the start of the segment
+		 */
+		MySharedArena* arena () const {
+			return reinterpret_cast<MySharedArena*>(_p);}
+
+		// ----
+		// size
+		/**
+		 * Returns the mapped size in bytes
+		 */
+		size_type size () const {
+			return _n;}
+
+		// ------
+		// remove
+		/**
+		 * Removes the segment name; mappings stay valid until they are unmapped
+		 * Returns whether name existed
+		 */
+		static bool remove (const char* name) {
+			return !shm_unlink(name);}};
+
+// ------------------
+// MySegmentAllocator
+/**
+ * An allocator over a MySharedArena
+ * It refers to the arena through an offset pointer, so it can itself live
+ * in the segment.
+ */
+template <typename T>
+class MySegmentAllocator {
+	public:
+		// --------
+		// typedefs
+		typedef T					value_type;
+		typedef T*					pointer;
+		typedef const T*			const_pointer;
+		typedef T&					reference;
+		typedef const T&			const_reference;
+		typedef std::size_t			size_type;
+		typedef std::ptrdiff_t		difference_type;
+
+		template <typename U>
+		struct rebind {
+			typedef MySegmentAllocator<U> other;};
+
+	public:
+		// -----------
+		// operator ==
+		friend bool operator == (const MySegmentAllocator& lhs, const MySegmentAllocator& rhs) {
+			return lhs.arena() == rhs.arena();}
+
+		friend bool operator != (const MySegmentAllocator& lhs, const MySegmentAllocator& rhs) {
+			return !(lhs == rhs);}
+
+	private:
+		// ----
+		// data
+		MyOffsetPtr<MySharedArena> _arena;
+
+	public:
+		// ------------
+		// constructors
+		/**
+		 * Returns an allocator over a
+		 */
+		explicit MySegmentAllocator (MySharedArena* a) :
+			_arena(a) {}
+
+		template <typename U>
+		MySegmentAllocator (const MySegmentAllocator<U>& that) :
+			_arena(that.arena()) {}
+
+		// --------
+		// allocate
+		pointer allocate (size_type n) {
+			return static_cast<pointer>(_arena->allocate(n * sizeof(T)));}
+
+		// -----
+		// arena
+		MySharedArena* arena () const {
+			return _arena.get();}
+
+		// ---------
+		// construct
+		void construct (pointer p, const_reference v) {
+			new (p) T(v);}
+
+		// ----------
+		// deallocate
+		void deallocate (pointer p, size_type) {
+			_arena->deallocate(p);}
+
+		// -------
+		// destroy
+		void destroy (pointer p) {
+			p->~T();}
+
+		// --------
+		// max_size
+		size_type max_size () const {
+			return _arena->capacity() / sizeof(T);}};
+
+// -------------
+// MySharedDeque
+/**
+ * A deque that lives in shared memory and is safe to use from several
+ * processes at once
+ * It has MyDeque's layout, one buffer with _front <= _begin <= _end <=
+ * _back, but the four pointers are offsets, the buffer comes from A, and
+ * every operation holds a process-shared mutex. Elements are copied
+ * straight into and out of the segment. T must itself be position
+ * independent: no raw pointers, no heap members.
+ */
+template < typename T, typename A = MySegmentAllocator<T> >
+class MySharedDeque {
+	public:
+		// --------
+		// typedefs
+		typedef A							allocator_type;
+		typedef T							value_type;
+		typedef std::size_t					size_type;
+		typedef std::ptrdiff_t				difference_type;
+		typedef value_type*					pointer;
+		typedef const value_type&			const_reference;
+
+	private:
+		// ----
+		// data
+		allocator_type _a;
+
+		MyOffsetPtr<value_type> _front;	// front of allocated space
+		MyOffsetPtr<value_type> _begin;	// beginning of used space
+		MyOffsetPtr<value_type> _end;	// end of used space
+		MyOffsetPtr<value_type> _back;	// back of allocated space
+
+		mutable pthread_mutex_t _m;
+		pthread_cond_t _ready;			// signalled by push and close
+		bool _closed;
+
+	private:
+		MySharedDeque (const MySharedDeque&);
+		MySharedDeque& operator = (const MySharedDeque&);
+
+		// -----
+		// valid
+		bool valid () const {
+			return (!_front && !_begin && !_end && !_back) ||
+				((_front <= _begin) && (_begin <= _end) && (_end <= _back));}
+
+	public:
+		// ------
+		// create
+		/**
+		 * Constructs a deque in m's arena and makes it the root object
+		 */
+		static MySharedDeque* create (MySharedMemory& m) {
+			MySharedArena* a = m.arena();
+			void* p = a->allocate(sizeof(MySharedDeque));
+			MySharedDeque* d;
+			try {
+				d = new (p) MySharedDeque(allocator_type(a));}
+			catch (...) {
+				a->deallocate(p);
+				throw;}
+			a->root(d);
+			return d;}
+
+		// ------
+		// attach
+		/**
+		 * Returns the deque that create() put in m
+		 */
+		static MySharedDeque* attach (MySharedMemory& m) {
+			assert(m.arena()->root());
+			return static_cast<MySharedDeque*>(m.arena()->root());}
+
+		// -------
+		// dispose
+		/**
+		 * Destroys the deque in m and frees its memory
+		 * No other process may be using it.
+		 */
+		static void dispose (MySharedMemory& m) {
+			MySharedDeque* d = attach(m);
+			d->~MySharedDeque();
+			m.arena()->deallocate(d);
+			m.arena()->root(0);}
+
+	public:
+		// -----------
+		// constructor
+		/**
+		 * Returns an empty, open deque allocating from a
+		 */
+		explicit MySharedDeque (const allocator_type& a) :
+				_a(a), _closed(false) {
+			MySharedLock::init(&_m);
+			try {
+				MySharedLock::init(&_ready);}
+			catch (...) {
+				pthread_mutex_destroy(&_m);
+				throw;}
+			assert(valid());}
+
+		// ----------
+		// destructor
+		~MySharedDeque () {
+			if (_front) {
+				destroy(_a, _begin.get(), _end.get());
+				_a.deallocate(_front, _back - _front);}
+			pthread_cond_destroy(&_ready);
+			pthread_mutex_destroy(&_m);}
+
+		// -----
+		// close
+		/**
+		 * Wakes every waiting pop; once the deque is empty they return false
+		 */
+		void close () {
+			MySharedLock l(&_m);
+			_closed = true;
+			pthread_cond_broadcast(&_ready);}
+
+		// ------
+		// closed
+		/**
+		 * Returns whether close() has been called
+		 */
+		bool closed () const {
+			MySharedLock l(&_m);
+			return _closed;}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the deque is empty
+		 */
+		bool empty () const {
+			return !size();}
+
+		// --------
+		// pop_back
+		/**
+		 * Waits for an element or close(), then moves the last element into v
+		 * Returns false if the deque was closed and empty
+		 */
+		bool pop_back (value_type& v) {
+			MySharedLock l(&_m);
+			while (_begin == _end && !_closed)
+				l.wait(&_ready);
+			return take_back(v);}
+
+		// ---------
+		// pop_front
+		/**
+		 * Waits for an element or close(), then moves the first element into v
+		 * Returns false if the deque was closed and empty
+		 */
+		bool pop_front (value_type& v) {
+			MySharedLock l(&_m);
+			while (_begin == _end && !_closed)
+				l.wait(&_ready);
+			return take_front(v);}
+
+		// ---------
+		// push_back
+		/**
+		 * Appends a copy of v at the end and wakes one waiting pop
+		 */
+		void push_back (const_reference v) {
+			MySharedLock l(&_m);
+			if (_end == _back)
+				make_room(size_type(_end - _begin) + 1);
+			construct(_a, _end.get(), v);
+			++_end;
+			pthread_cond_signal(&_ready);
+			assert(valid());}
+
+		// ----------
+		// push_front
+		/**
+		 * Inserts a copy of v at the beginning and wakes one waiting pop
+		 */
+		void push_front (const_reference v) {
+			MySharedLock l(&_m);
+			if (_front == _begin)
+				make_room(size_type(_end - _begin) + 1);
+			construct(_a, _begin - 1, v);
+			--_begin;
+			pthread_cond_signal(&_ready);
+			assert(valid());}
+
+		// ----
+		// size
+		/**
+		 * Returns the current number of elements
+		 */
+		size_type size () const {
+			MySharedLock l(&_m);
+			return _end - _begin;}
+
+		// ------------
+		// try_pop_back
+		/**
+		 * Moves the last element into v without waiting
+		 * Returns false if the deque was empty
+		 */
+		bool try_pop_back (value_type& v) {
+			MySharedLock l(&_m);
+			return take_back(v);}
+
+		// -------------
+		// try_pop_front
+		/**
+		 * Moves the first element into v without waiting
+		 * Returns false if the deque was empty
+		 */
+		bool try_pop_front (value_type& v) {
+			MySharedLock l(&_m);
+			return take_front(v);}
+
+	private:
+		// ---------
+		// take_back
+		bool take_back (value_type& v) {
+			if (_begin == _end)
+				return false;
+			v = *(_end - 1);
+			--_end;
+			destroy(_a, _end.get());
+			assert(valid());
+			return true;}
+
+		// ----------
+		// take_front
+		bool take_front (value_type& v) {
+			if (_begin == _end)
+				return false;
+			v = *_begin;
+			destroy(_a, _begin.get());
+			++_begin;
+			assert(valid());
+			return true;}
+
+		// ---------
+		// make_room
+		/**
+		 * Makes room for s elements from _begin with at least one free slot in front
+		 * Follows MyDeque::make_room: recenters in place when the free space is
+		 * at least half of s, otherwise grows to max(s, 2 * size()) in the arena
+		 */
+		void make_room (size_type s) {
+			const size_type n = _end - _begin;
+			size_type capacity = _back - _front;
+			if (s <= capacity && s <= 2 * (capacity - s) && (capacity - s) / 2 > 0) {
+				pointer b = _front + (capacity - s) / 2;
+				if (b < _begin)
+					for (pointer p = _begin, q = b; p != _end; ++p, ++q) {
+						construct(_a, q, *p);
+						destroy(_a, p);}
+				else
+					for (pointer p = _end, q = b + n; p != _begin; ) {
+						construct(_a, --q, *--p);
+						destroy(_a, p);}
+				_begin = b;
+				_end = b + n;}
+			else {
+				capacity = std::max(s, 2 * n);
+				if ((capacity - s) / 2 == 0)
+					capacity += 3;
+				pointer f = _a.allocate(capacity);
+				pointer b = f + (capacity - s) / 2;
+				try {
+					uninitialized_copy(_a, _begin.get(), _end.get(), b);}
+				catch (...) {
+					_a.deallocate(f, capacity);
+					throw;}
+				if (_front) {
+					destroy(_a, _begin.get(), _end.get());
+					_a.deallocate(_front, _back - _front);}
+				_front = f;
+				_begin = b;
+				_end = b + n;
+				_back = f + capacity;}
+			assert(_front < _begin && s <= size_type(_back - _begin));}};
+
+#endif // SharedDeque_h
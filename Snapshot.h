@@ -0,0 +1,264 @@
+// ----------
+// Snapshot.h
+// ----------
+
+#ifndef Snapshot_h
+#define Snapshot_h
+
+// --------
+// includes
+#include <algorithm>	// max, min
+#include <cstddef>		// size_t
+#include <cstring>		// memcmp, memcpy
+#include <istream>		// istream
+#include <ostream>		// ostream
+#include <stdexcept>	// runtime_error
+#include <streambuf>	// streambuf
+#include <vector>		// vector
+
+#include <stdint.h>		// uint32_t, uint64_t
+
+// ----------
+// MyChecksum
+/**
+ * FNV-1a over 8-byte words, with any last partial word taken bytewise
+ * Blocks may be added one at a time as long as all but the last are a
+ * multiple of 8 bytes long.
+ */
+class MyChecksum {
+	private:
+		uint64_t _h;
+
+		static uint64_t prime () {
+			return (static_cast<uint64_t>(0x100) << 32) | 0x1B3;}
+
+	public:
+		MyChecksum () :
+				_h((static_cast<uint64_t>(0xCBF29CE4) << 32) | 0x84222325) {}
+
+		void add (const void* p, std::size_t n) {
+			const char* b = static_cast<const char*>(p);
+			for (; n >= 8; b += 8, n -= 8) {
+				uint64_t w;
+				std::memcpy(&w, b, 8);
+				_h = (_h ^ w) * prime();}
+			for (; n; ++b, --n)
+				_h = (_h ^ static_cast<unsigned char>(*b)) * prime();}
+
+		uint64_t value () const {
+			return _h;}};
+
+// ----------
+// MySnapshot
+/**
+ * The header of a snapshot of a deque, as written by MyDeque::save
+ * A snapshot is this 64-byte header followed by the payload: either the
+ * elements' own bytes (raw), or whatever a serializer wrote for each.
+ * The header holds the magic "MYDQSNAP", the version, sizeof(T), the
+ * flags, the element count, the payload length, and the payload's
+ * MyChecksum, in the byte order of the machine that wrote it. A raw
+ * payload starts 64 bytes in, so a mapped snapshot is aligned for T.
+ */
+struct MySnapshot {
+	enum {version = 1};
+	enum {size = 64};			// bytes in the header
+	enum {raw = 1};				// flag: the payload is the elements' bytes
+	enum {block = 1 << 20};		// bytes per read or write of a raw payload
+
+	uint32_t element;
+	uint32_t flags;
+	uint64_t count;
+	uint64_t bytes;
+	uint64_t checksum;
+
+	MySnapshot (uint32_t e = 0, uint32_t f = 0, uint64_t c = 0, uint64_t b = 0) :
+			element(e), flags(f), count(c), bytes(b), checksum(0) {}
+
+	// ------
+	// decode
+	/**
+	 * Fills this from the size bytes at p
+	 * Throws runtime_error if they are not a snapshot header
+	 */
+	void decode (const char* p) {
+		uint32_t v;
+		std::memcpy(&v, p + 8, 4);
+		if (std::memcmp(p, "MYDQSNAP", 8) || v != version)
+			throw std::runtime_error("deque::load: not a snapshot");
+		std::memcpy(&element, p + 12, 4);
+		std::memcpy(&flags, p + 16, 4);
+		std::memcpy(&count, p + 24, 8);
+		std::memcpy(&bytes, p + 32, 8);
+		std::memcpy(&checksum, p + 40, 8);}
+
+	// -----
+	// check
+	/**
+	 * Throws runtime_error unless this describes a payload of Ts that is
+	 * raw, or not, as r says
+	 */
+	void check (std::size_t e, bool r) const {
+		if (element != e)
+			throw std::runtime_error("deque::load: wrong element size");
+		if (!(flags & raw) != !r)
+			throw std::runtime_error("deque::load: wrong payload kind");
+		// count * e could wrap
+		if (r && (bytes % e || bytes / e != count))
+			throw std::runtime_error("deque::load: wrong payload length");}
+
+	// ----
+	// fits
+	/**
+	 * Throws runtime_error if in can seek and has fewer than bytes left
+	 * Returns whether in could seek, so that bytes is known to be real
+	 * and may be allocated up front
+	 */
+	bool fits (std::istream& in) const {
+		const std::streampos p = in.tellg();
+		if (p == std::streampos(-1))
+			return false;
+		in.seekg(0, std::ios::end);
+		const std::streampos e = in.tellg();
+		if (e == std::streampos(-1)) {
+			in.clear();
+			in.seekg(p);
+			return false;}
+		in.seekg(p);
+		if (static_cast<uint64_t>(e - p) < bytes)
+			throw std::runtime_error("deque::load: truncated snapshot");
+		return true;}
+
+	// ----
+	// read
+	/**
+	 * Reads a header from in
+	 * Throws runtime_error if there is none
+	 */
+	void read (std::istream& in) {
+		char h[size];
+		if (!in.read(h, size))
+			throw std::runtime_error("deque::load: not a snapshot");
+		decode(h);}
+
+	// -----
+	// write
+	void write (std::ostream& out) const {
+		char h[size] = {0};
+		const uint32_t v = version;
+		std::memcpy(h, "MYDQSNAP", 8);
+		std::memcpy(h + 8, &v, 4);
+		std::memcpy(h + 12, &element, 4);
+		std::memcpy(h + 16, &flags, 4);
+		std::memcpy(h + 24, &count, 8);
+		std::memcpy(h + 32, &bytes, 8);
+		std::memcpy(h + 40, &checksum, 8);
+		out.write(h, size);}};
+
+// -------------
+// MySnapshotOut
+/**
+ * The stream buffer a serializer writes a payload through: it passes it
+ * on to an ostream, if it has one, MySnapshot::block bytes at a time,
+ * and keeps its length and MyChecksum
+ * Without an ostream it only measures, which is how the header is
+ * filled in before the payload is written.
+ */
+class MySnapshotOut : public std::streambuf {
+	private:
+		std::ostream* _out;
+		std::vector<char> _buffer;
+		MyChecksum _checksum;
+		uint64_t _bytes;
+
+		MySnapshotOut (const MySnapshotOut&);
+		MySnapshotOut& operator = (const MySnapshotOut&);
+
+	protected:
+		int_type overflow (int_type c) {
+			finish();
+			if (!traits_type::eq_int_type(c, traits_type::eof())) {
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);}
+			return traits_type::not_eof(c);}
+
+		// a flush mid-payload would break the checksum into uneven pieces
+		int sync () {
+			return 0;}
+
+	public:
+		explicit MySnapshotOut (std::ostream* out = 0) :
+				_out(out), _buffer(MySnapshot::block), _bytes(0) {
+			setp(&_buffer[0], &_buffer[0] + _buffer.size());}
+
+		/**
+		 * Passes on what is buffered; call it once the payload is complete
+		 */
+		void finish () {
+			const std::size_t n = pptr() - pbase();
+			_checksum.add(pbase(), n);
+			_bytes += n;
+			if (_out && n)
+				_out->write(pbase(), n);
+			setp(&_buffer[0], &_buffer[0] + _buffer.size());}
+
+		uint64_t bytes () const {
+			return _bytes;}
+
+		uint64_t checksum () const {
+			return _checksum.value();}};
+
+// ------------
+// MySnapshotIn
+/**
+ * The stream buffer a serializer reads a payload through: it reads the
+ * payload's bytes from an istream MySnapshot::block bytes at a time, and
+ * no further, and keeps their MyChecksum
+ */
+class MySnapshotIn : public std::streambuf {
+	private:
+		std::istream& _in;
+		std::vector<char> _buffer;
+		MyChecksum _checksum;
+		uint64_t _left;
+		bool _truncated;
+
+		MySnapshotIn (const MySnapshotIn&);
+		MySnapshotIn& operator = (const MySnapshotIn&);
+
+	protected:
+		int_type underflow () {
+			if (gptr() < egptr())
+				return traits_type::to_int_type(*gptr());
+			if (!_left)
+				return traits_type::eof();
+			const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(_buffer.size(), _left));
+			if (!_in.read(&_buffer[0], n)) {
+				_left = 0;
+				_truncated = true;
+				return traits_type::eof();}
+			_checksum.add(&_buffer[0], n);
+			_left -= n;
+			setg(&_buffer[0], &_buffer[0], &_buffer[0] + n);
+			return traits_type::to_int_type(*gptr());}
+
+	public:
+		MySnapshotIn (std::istream& in, uint64_t bytes) :
+				_in(in),
+				_buffer(static_cast<std::size_t>(std::max<uint64_t>(1, std::min<uint64_t>(MySnapshot::block, bytes)))),
+				_left(bytes), _truncated(false) {
+			setg(&_buffer[0], &_buffer[0], &_buffer[0]);}
+
+		/**
+		 * Reads whatever of the payload the serializer left
+		 * Returns false if in ended before the payload did
+		 */
+		bool finish () {
+			while (_left) {
+				setg(egptr(), egptr(), egptr());
+				underflow();}
+			return !_truncated;}
+
+		uint64_t checksum () const {
+			return _checksum.value();}};
+
+#endif // Snapshot_h
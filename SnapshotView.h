@@ -0,0 +1,100 @@
+// --------------
+// SnapshotView.h
+// --------------
+
+#ifndef SnapshotView_h
+#define SnapshotView_h
+
+// --------
+// includes
+#include <cstddef>		// size_t
+#include <stdexcept>	// runtime_error
+
+#include <fcntl.h>		// open, O_RDONLY
+#include <sys/mman.h>	// mmap, munmap
+#include <sys/stat.h>	// fstat
+#include <unistd.h>		// close
+
+#include "Mapping.h"	// is_mappable
+#include "Snapshot.h"	// MyChecksum, MySnapshot
+
+// --------------
+// MySnapshotView
+/**
+ * A raw snapshot file mapped read-only: its elements are usable at once,
+ * and pages are read from the file as they are first touched
+ * Checking the checksum reads the whole file, so it is left to the caller.
+ * It needs POSIX mmap, so it has a header of its own, which Deque.h
+ * leaves out.
+ */
+template <typename T>
+class MySnapshotView {
+	public:
+		typedef T				value_type;
+		typedef std::size_t		size_type;
+		typedef const T*		const_iterator;
+		typedef const T&		const_reference;
+
+	private:
+		void* _map;
+		std::size_t _length;
+		MySnapshot _header;
+
+		MySnapshotView (const MySnapshotView&);
+		MySnapshotView& operator = (const MySnapshotView&);
+
+	public:
+		/**
+		 * Maps the snapshot in path, and reads all of it to check the
+		 * checksum if verify is true
+		 * Throws runtime_error if path is not a raw snapshot of Ts
+		 */
+		explicit MySnapshotView (const char* path, bool verify = false) :
+				_map(MAP_FAILED), _length(0) {
+			(void)sizeof(char[is_mappable<T>::value ? 1 : -1]);
+			const int fd = open(path, O_RDONLY);
+			if (fd == -1)
+				throw std::runtime_error("deque::load: cannot open snapshot");
+			struct stat s;
+			if (fstat(fd, &s) == 0 && s.st_size >= MySnapshot::size) {
+				_length = s.st_size;
+				_map = mmap(0, _length, PROT_READ, MAP_PRIVATE, fd, 0);}
+			close(fd);
+			if (_map == MAP_FAILED)
+				throw std::runtime_error("deque::load: not a snapshot");
+			try {
+				_header.decode(static_cast<const char*>(_map));
+				_header.check(sizeof(T), true);
+				if (_length - MySnapshot::size < _header.bytes)
+					throw std::runtime_error("deque::load: truncated snapshot");
+				if (verify) {
+					MyChecksum c;
+					c.add(begin(), _header.bytes);
+					if (c.value() != _header.checksum)
+						throw std::runtime_error("deque::load: bad checksum");}}
+			catch (...) {
+				munmap(_map, _length);
+				throw;}}
+
+		~MySnapshotView () {
+			munmap(_map, _length);}
+
+		const_reference operator [] (size_type n) const {
+			return begin()[n];}
+
+		const_iterator begin () const {
+			return reinterpret_cast<const T*>(static_cast<const char*>(_map) + MySnapshot::size);}
+
+		const T* data () const {
+			return begin();}
+
+		bool empty () const {
+			return !size();}
+
+		const_iterator end () const {
+			return begin() + size();}
+
+		size_type size () const {
+			return _header.count;}};
+
+#endif // SnapshotView_h
@@ -10,12 +10,23 @@ To test the program:
 
 // --------
 // includes
-#include <algorithm> // equal
+#include <algorithm> // equal, max_element, min_element
+#include <climits>   // LONG_MAX, LONG_MIN
+#include <cstdio>    // remove
+#include <cstdlib>   // rand, srand
 #include <cstring>   // strcmp
+#include <fstream>   // ofstream
 #include <deque>	 // deque
-#include <sstream>   // ostringstream
+#include <functional> // greater, plus
+#include <iterator>  // istream_iterator
+#include <list>	  // list
+#include <sstream>   // istringstream, ostringstream, stringstream
 #include <stdexcept> // invalid_argument
 #include <string>	// ==
+#include <vector>	// vector
+
+#include <sys/wait.h> // waitpid
+#include <unistd.h>   // _exit, fork, getpid
 
 #include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
 #include "cppunit/TestFixture.h"			 // TestFixture
@@ -23,6 +34,27 @@ To test the program:
 #include "cppunit/TextTestRunner.h"		  // TestRunner
 
 #include "Deque.h"
+#include "BitDeque.h"
+#include "GapDeque.h"
+#include "IncrementalDeque.h"
+#include "Window.h"
+#include "CompressedDeque.h"
+#include "SharedDeque.h"
+#include "SnapshotView.h"
+#include "TimerWheel.h"
+#include "Vector.h"
+
+#if __cplusplus >= 201703L
+#include <array>	 // array
+#include <tuple>	 // get, tuple
+#include <utility>   // pair
+
+#include "ColumnDeque.h"
+#endif
+
+#if __cplusplus > 201703L
+#include "Channel.h"
+#endif
 
 // ---------
 // TestDeque
@@ -1656,6 +1688,2381 @@ struct TestDeque : CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE_END();
 };
 
+// ------------
+// TestGapDeque
+struct TestGapDeque : CppUnit::TestFixture {
+	typedef MyGapDeque<int> C;
+
+	// ------
+	// cursor
+	void test_cursor_1 () {
+		C x(5, 1);
+		CPPUNIT_ASSERT(x.cursor() == 5);
+		x.move_cursor(2);
+		CPPUNIT_ASSERT(x.cursor() == 2);
+		CPPUNIT_ASSERT(x.size() == 5);
+	}
+
+	void test_cursor_2 () {
+		C x;
+		for (int i = 0; i < 10; ++i)
+			x.push_back(i);
+		x.move_cursor(3);
+		for (int i = 0; i < 10; ++i)
+			CPPUNIT_ASSERT(x[i] == i);
+		x.move_cursor(8);
+		for (int i = 0; i < 10; ++i)
+			CPPUNIT_ASSERT(x[i] == i);
+	}
+
+	void test_cursor_3 () {
+		C x;
+		for (int i = 0; i < 10; ++i)
+			x.push_back(i);
+		x.move_cursor(4);
+		C::iterator b = x.begin();
+		for (int i = 0; i < 10; ++i, ++b)
+			CPPUNIT_ASSERT(*b == i);
+		CPPUNIT_ASSERT(b == x.end());
+	}
+
+	// ------
+	// insert
+	void test_insert_1 () {
+		C x;
+		for (int i = 0; i < 6; ++i)
+			x.push_back(i);
+		x.move_cursor(3);
+		const C::size_type c = x.capacity();
+		C::iterator p = x.insert(x.begin() + 3, 30);
+		CPPUNIT_ASSERT(*p == 30);
+		CPPUNIT_ASSERT(x.cursor() == 4);
+		CPPUNIT_ASSERT(x.capacity() == c);
+		x.insert(x.begin() + 4, 31);
+		CPPUNIT_ASSERT(x.size() == 8);
+		CPPUNIT_ASSERT(x[2] == 2);
+		CPPUNIT_ASSERT(x[3] == 30);
+		CPPUNIT_ASSERT(x[4] == 31);
+		CPPUNIT_ASSERT(x[5] == 3);
+		CPPUNIT_ASSERT(x.back() == 5);
+	}
+
+	void test_insert_2 () {
+		C x(3, 7);
+		for (int i = 0; i < 100; ++i)
+			x.insert(x.begin() + 1 + i, i);
+		CPPUNIT_ASSERT(x.size() == 103);
+		CPPUNIT_ASSERT(x.front() == 7);
+		for (int i = 0; i < 100; ++i)
+			CPPUNIT_ASSERT(x[1 + i] == i);
+		CPPUNIT_ASSERT(x[101] == 7);
+		CPPUNIT_ASSERT(x.back() == 7);
+	}
+
+	void test_insert_3 () {
+		C x;
+		x.push_back(2);
+		x.push_front(1);
+		x.insert(x.begin() + 1, x[0]);
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(x[0] == 1);
+		CPPUNIT_ASSERT(x[1] == 1);
+		CPPUNIT_ASSERT(x[2] == 2);
+	}
+
+	// -----
+	// erase
+	void test_erase_1 () {
+		C x;
+		for (int i = 0; i < 10; ++i)
+			x.push_back(i);
+		C::iterator p = x.erase(x.begin() + 4);
+		CPPUNIT_ASSERT(*p == 5);
+		CPPUNIT_ASSERT(x.cursor() == 4);
+		x.erase(p);
+		CPPUNIT_ASSERT(x.size() == 8);
+		CPPUNIT_ASSERT(x[3] == 3);
+		CPPUNIT_ASSERT(x[4] == 6);
+		CPPUNIT_ASSERT(x.back() == 9);
+	}
+
+	void test_erase_2 () {
+		C x;
+		for (int i = 0; i < 10; ++i)
+			x.push_back(i);
+		x.move_cursor(5);
+		x.pop_front();
+		x.pop_back();
+		CPPUNIT_ASSERT(x.size() == 8);
+		CPPUNIT_ASSERT(x.front() == 1);
+		CPPUNIT_ASSERT(x.back() == 8);
+	}
+
+	void test_erase_3 () {
+		C x;
+		for (int i = 0; i < 10; ++i)
+			x.push_back(i);
+		x.move_cursor(5);
+		x.resize(3);
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(x.back() == 2);
+		x.resize(5, 9);
+		CPPUNIT_ASSERT(x[3] == 9);
+		CPPUNIT_ASSERT(x[4] == 9);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestGapDeque);
+	CPPUNIT_TEST(test_cursor_1);
+	CPPUNIT_TEST(test_cursor_2);
+	CPPUNIT_TEST(test_cursor_3);
+	CPPUNIT_TEST(test_insert_1);
+	CPPUNIT_TEST(test_insert_2);
+	CPPUNIT_TEST(test_insert_3);
+	CPPUNIT_TEST(test_erase_1);
+	CPPUNIT_TEST(test_erase_2);
+	CPPUNIT_TEST(test_erase_3);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// --------
+// Counters
+/**
+ * Tallies of allocator and element activity, reset by each complexity test
+ * C++98 has no moves, so every relocation shows up as a copy
+ */
+struct Counters {
+	static int allocations;
+	static int deallocations;
+	static int constructions;
+	static int copies;
+	static int assignments;
+	static int destructions;
+
+	static void reset () {
+		allocations = deallocations = 0;
+		constructions = copies = assignments = destructions = 0;}};
+
+int Counters::allocations;
+int Counters::deallocations;
+int Counters::constructions;
+int Counters::copies;
+int Counters::assignments;
+int Counters::destructions;
+
+// -------
+// Counted
+/**
+ * An int that reports its constructions, copies, assignments and destructions
+ */
+struct Counted {
+	int v;
+
+	Counted (int i = 0) : v(i) {
+		++Counters::constructions;}
+
+	Counted (const Counted& that) : v(that.v) {
+		++Counters::copies;}
+
+	Counted& operator = (const Counted& that) {
+		v = that.v;
+		++Counters::assignments;
+		return *this;}
+
+	~Counted () {
+		++Counters::destructions;}
+
+	friend bool operator == (const Counted& lhs, const Counted& rhs) {
+		return lhs.v == rhs.v;}
+
+	friend bool operator < (const Counted& lhs, const Counted& rhs) {
+		return lhs.v < rhs.v;}};
+
+// -----------------
+// CountingAllocator
+/**
+ * A std::allocator that reports every allocate and deallocate
+ */
+template <typename T>
+struct CountingAllocator : std::allocator<T> {
+	typedef std::allocator<T>		base;
+	typedef typename base::size_type	size_type;
+	typedef T*				pointer;
+
+	template <typename U>
+	struct rebind {
+		typedef CountingAllocator<U> other;};
+
+	CountingAllocator () {}
+
+	template <typename U>
+	CountingAllocator (const CountingAllocator<U>&) {}
+
+	pointer allocate (size_type n, const void* = 0) {
+		++Counters::allocations;
+		return base::allocate(n);}
+
+	void deallocate (pointer p, size_type n) {
+		++Counters::deallocations;
+		base::deallocate(p, n);}};
+
+// --------------
+// TestComplexity
+/**
+ * Performance contracts of MyDeque, checked by counting instead of timing
+ */
+struct TestComplexity : CppUnit::TestFixture {
+	typedef MyDeque<Counted, CountingAllocator<Counted> > C;
+
+	// ---------
+	// push_back
+	void test_push_back_1 () {
+		const int n = 100000;
+		const Counted v(1);
+		C x;
+		Counters::reset();
+		for (int i = 0; i < n; ++i)
+			x.push_back(v);
+		CPPUNIT_ASSERT(x.size() == (C::size_type)n);
+		CPPUNIT_ASSERT(Counters::allocations <= 40);
+		CPPUNIT_ASSERT(Counters::copies <= 5 * n);
+		CPPUNIT_ASSERT(Counters::constructions == 0);
+		CPPUNIT_ASSERT(Counters::assignments == 0);
+	}
+
+	void test_push_back_2 () {
+		const Counted v(1);
+		C x;
+		int relocations = 0;
+		for (int i = 0; i < 10000; ++i) {
+			const int s = x.size();
+			Counters::reset();
+			x.push_back(v);
+			CPPUNIT_ASSERT(Counters::copies <= s + 2);
+			if (Counters::copies > 1)
+				++relocations;}
+		CPPUNIT_ASSERT(relocations <= 40);
+	}
+
+	// ----------
+	// push_front
+	void test_push_front_1 () {
+		const int n = 100000;
+		const Counted v(1);
+		C x;
+		Counters::reset();
+		for (int i = 0; i < n; ++i)
+			x.push_front(v);
+		CPPUNIT_ASSERT(x.size() == (C::size_type)n);
+		CPPUNIT_ASSERT(Counters::allocations <= 40);
+		CPPUNIT_ASSERT(Counters::copies <= 5 * n);
+		CPPUNIT_ASSERT(Counters::assignments == 0);
+	}
+
+	void test_push_front_2 () {
+		const Counted v(1);
+		C x;
+		int relocations = 0;
+		for (int i = 0; i < 10000; ++i) {
+			const int s = x.size();
+			Counters::reset();
+			x.push_front(v);
+			CPPUNIT_ASSERT(Counters::copies <= s + 2);
+			if (Counters::copies > 1)
+				++relocations;}
+		CPPUNIT_ASSERT(relocations <= 40);
+	}
+
+	// ---
+	// pop
+	void test_pop_1 () {
+		const int n = 10000;
+		C x(n, Counted(1));
+		Counters::reset();
+		for (int i = 0; i < n / 2; ++i) {
+			x.pop_back();
+			x.pop_front();}
+		CPPUNIT_ASSERT(x.empty());
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::constructions == 0);
+		CPPUNIT_ASSERT(Counters::copies == 0);
+		CPPUNIT_ASSERT(Counters::destructions == n);
+	}
+
+	// ----
+	// fifo
+	void test_fifo_1 () {
+		const int n = 1000;
+		const int m = 100000;
+		const Counted v(1);
+		C x(n, v);
+		for (int i = 0; i < 4 * n; ++i) {
+			x.push_back(v);
+			x.pop_front();}
+		Counters::reset();
+		for (int i = 0; i < m; ++i) {
+			x.push_back(v);
+			x.pop_front();}
+		CPPUNIT_ASSERT(x.size() == (C::size_type)n);
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::deallocations == 0);
+		CPPUNIT_ASSERT(Counters::copies <= 5 * m);
+	}
+
+	void test_fifo_2 () {
+		const int n = 1000;
+		const int m = 100000;
+		const Counted v(1);
+		C x(n, v);
+		for (int i = 0; i < 4 * n; ++i) {
+			x.push_front(v);
+			x.pop_back();}
+		Counters::reset();
+		for (int i = 0; i < m; ++i) {
+			x.push_front(v);
+			x.pop_back();}
+		CPPUNIT_ASSERT(x.size() == (C::size_type)n);
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::copies <= 5 * m);
+	}
+
+	// ----
+	// swap
+	void test_swap_1 () {
+		C x(10000, Counted(1));
+		C y(20000, Counted(2));
+		Counters::reset();
+		x.swap(y);
+		CPPUNIT_ASSERT(x.size() == 20000);
+		CPPUNIT_ASSERT(y.size() == 10000);
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::constructions == 0);
+		CPPUNIT_ASSERT(Counters::copies == 0);
+		CPPUNIT_ASSERT(Counters::assignments == 0);
+		CPPUNIT_ASSERT(Counters::destructions == 0);
+	}
+
+	// ----
+	// copy
+	void test_copy_1 () {
+		const C x(10000, Counted(1));
+		Counters::reset();
+		const C y(x);
+		CPPUNIT_ASSERT(y == x);
+		CPPUNIT_ASSERT(Counters::allocations == 1);
+		CPPUNIT_ASSERT(Counters::copies == 10000);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestComplexity);
+	CPPUNIT_TEST(test_push_back_1);
+	CPPUNIT_TEST(test_push_back_2);
+	CPPUNIT_TEST(test_push_front_1);
+	CPPUNIT_TEST(test_push_front_2);
+	CPPUNIT_TEST(test_pop_1);
+	CPPUNIT_TEST(test_fifo_1);
+	CPPUNIT_TEST(test_fifo_2);
+	CPPUNIT_TEST(test_swap_1);
+	CPPUNIT_TEST(test_copy_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// -----------------
+// TestGapComplexity
+struct TestGapComplexity : CppUnit::TestFixture {
+	typedef MyGapDeque<Counted, CountingAllocator<Counted> > C;
+
+	// ----
+	// push
+	void test_push_1 () {
+		const int n = 100000;
+		const Counted v(1);
+		C x;
+		x.push_back(v);
+		x.push_back(v);
+		x.move_cursor(1);
+		Counters::reset();
+		for (int i = 0; i < n; ++i) {
+			x.push_back(v);
+			x.push_front(v);}
+		CPPUNIT_ASSERT(x.size() == (C::size_type)(2 * n + 2));
+		CPPUNIT_ASSERT(x.cursor() == (C::size_type)(n + 1));
+		CPPUNIT_ASSERT(Counters::allocations <= 40);
+		CPPUNIT_ASSERT(Counters::copies <= 5 * 2 * n);
+		CPPUNIT_ASSERT(Counters::assignments == 0);
+	}
+
+	// ---
+	// pop
+	void test_pop_1 () {
+		const int n = 10000;
+		C x(n, Counted(1));
+		x.move_cursor(n / 3);
+		Counters::reset();
+		for (int i = 0; i < n / 2; ++i) {
+			x.pop_back();
+			x.pop_front();}
+		CPPUNIT_ASSERT(x.empty());
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::copies == 0);
+		CPPUNIT_ASSERT(Counters::destructions == n);
+	}
+
+	// ----
+	// fifo
+	void test_fifo_1 () {
+		const int n = 1000;
+		const int m = 100000;
+		const Counted v(1);
+		C x(n, v);
+		for (int i = 0; i < 4 * n; ++i) {
+			x.push_back(v);
+			x.pop_front();}
+		Counters::reset();
+		for (int i = 0; i < m; ++i) {
+			x.push_back(v);
+			x.pop_front();}
+		CPPUNIT_ASSERT(x.size() == (C::size_type)n);
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::deallocations == 0);
+		CPPUNIT_ASSERT(Counters::copies <= 5 * m);
+	}
+
+	void test_fifo_2 () {
+		const int n = 1000;
+		const int m = 100000;
+		const Counted v(1);
+		C x(n, v);
+		x.move_cursor(n / 2);
+		for (int i = 0; i < 4 * n; ++i) {
+			x.push_front(v);
+			x.pop_back();}
+		Counters::reset();
+		for (int i = 0; i < m; ++i) {
+			x.push_front(v);
+			x.pop_back();}
+		CPPUNIT_ASSERT(x.size() == (C::size_type)n);
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::copies <= 5 * m);
+	}
+
+	// ----
+	// edit
+	void test_edit_1 () {
+		// edits at the cursor still shift nothing but the gap's edge
+		const int n = 1000;
+		const Counted v(1);
+		C x(10000, v);
+		x.move_cursor(5000);
+		x.insert(x.begin() + 5000, v);
+		Counters::reset();
+		for (int i = 0; i < n; ++i) {
+			x.insert(x.begin() + 5001 + i, v);
+			x.push_back(v);}
+		CPPUNIT_ASSERT(x.cursor() == (C::size_type)(5001 + n));
+		CPPUNIT_ASSERT(Counters::allocations == 0);
+		CPPUNIT_ASSERT(Counters::copies <= 2 * 2 * n);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestGapComplexity);
+	CPPUNIT_TEST(test_push_1);
+	CPPUNIT_TEST(test_pop_1);
+	CPPUNIT_TEST(test_fifo_1);
+	CPPUNIT_TEST(test_fifo_2);
+	CPPUNIT_TEST(test_edit_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// ----------
+// TestAssign
+struct TestAssign : CppUnit::TestFixture {
+	typedef MyDeque<Counted, CountingAllocator<Counted> > C;
+
+	// -----------
+	// constructor
+	void test_constructor_1 () {
+		const int a[] = {2, 3, 5, 7, 11};
+		const std::vector<int> v(a, a + 5);
+		const std::list<int> l(a, a + 5);
+		MyDeque<int> x(v.begin(), v.end());
+		MyDeque<int> y(l.begin(), l.end());
+		MyDeque<int> z(a, a + 5);
+		CPPUNIT_ASSERT(x.size() == 5);
+		CPPUNIT_ASSERT(std::equal(a, a + 5, x.begin()));
+		CPPUNIT_ASSERT(x == y);
+		CPPUNIT_ASSERT(x == z);
+		MyDeque<int> w(x.begin(), x.end());
+		CPPUNIT_ASSERT(w == x);
+		MyDeque<int> e(a, a);
+		CPPUNIT_ASSERT(e.empty());
+	}
+
+	void test_constructor_2 () {
+		// two ints mean a count and a value, not a range
+		MyDeque<int> x(5, 7);
+		CPPUNIT_ASSERT(x.size() == 5);
+		CPPUNIT_ASSERT(x.front() == 7);
+		MyDeque<long> y(3L, 4L);
+		CPPUNIT_ASSERT(y.size() == 3);
+		CPPUNIT_ASSERT(y.back() == 4);
+	}
+
+	void test_constructor_3 () {
+		std::istringstream in("1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20");
+		MyDeque<int> x((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+		CPPUNIT_ASSERT(x.size() == 20);
+		for (int i = 0; i < 20; ++i)
+			CPPUNIT_ASSERT(x[i] == i + 1);
+		x.push_front(0);
+		CPPUNIT_ASSERT(x.front() == 0);
+	}
+
+	// ------
+	// assign
+	void test_assign_1 () {
+		const int a[] = {1, 2, 3};
+		MyDeque<int> x(10, 9);
+		x.assign(a, a + 3);
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(std::equal(a, a + 3, x.begin()));
+		x.assign(4, 8);
+		CPPUNIT_ASSERT(x.size() == 4);
+		CPPUNIT_ASSERT(x[3] == 8);
+		x.assign(20, 1);
+		CPPUNIT_ASSERT(x.size() == 20);
+		x.push_back(2);
+		x.push_front(0);
+		CPPUNIT_ASSERT(x.size() == 22);
+		x.assign(x.size(), x.back());
+		CPPUNIT_ASSERT(x.front() == 2);
+		std::istringstream in("4 5 6");
+		x.assign(std::istream_iterator<int>(in), std::istream_iterator<int>());
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(x.front() == 4);
+		CPPUNIT_ASSERT(x.back() == 6);
+		x.assign(a, a);
+		CPPUNIT_ASSERT(x.empty());
+	}
+
+	// ----------
+	// allocation
+	void test_allocation_1 () {
+		const int n = 100000;
+		std::list<Counted> l;
+		for (int i = 0; i < n; ++i)
+			l.push_back(Counted(i));
+		Counters::reset();
+		{
+		C x(l.begin(), l.end());
+		CPPUNIT_ASSERT(Counters::allocations == 1);
+		CPPUNIT_ASSERT(Counters::copies == n);
+		CPPUNIT_ASSERT(x.back().v == n - 1);
+		x.assign(l.begin(), l.end());
+		CPPUNIT_ASSERT(Counters::allocations == 1);
+		x.pop_back();
+		x.assign(l.begin(), l.end());
+		CPPUNIT_ASSERT(Counters::allocations == 1);
+		x.push_back(Counted(n));
+		CPPUNIT_ASSERT(Counters::allocations == 2);
+		x.assign(n / 2, Counted(0));
+		CPPUNIT_ASSERT(Counters::allocations == 2);
+		}
+		CPPUNIT_ASSERT(Counters::allocations == Counters::deallocations);
+	}
+
+	void test_allocation_2 () {
+		const int n = 100000;
+		std::ostringstream out;
+		for (int i = 0; i < n; ++i)
+			out << i << " ";
+		std::istringstream in(out.str());
+		Counters::reset();
+		MyDeque<int, CountingAllocator<int> > x((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+		CPPUNIT_ASSERT(x.size() == (unsigned)n);
+		CPPUNIT_ASSERT(x[n - 1] == n - 1);
+		// blocks double from 16, so about log2(n / 16) allocations
+		CPPUNIT_ASSERT(Counters::allocations <= 14);
+	}
+
+#if __cplusplus >= 201103L
+	// ----------------
+	// initializer_list
+	void test_initializer_list_1 () {
+		MyDeque<int> x = {1, 2, 3, 4};
+		CPPUNIT_ASSERT(x.size() == 4);
+		CPPUNIT_ASSERT(x[2] == 3);
+		x.assign({5, 6});
+		CPPUNIT_ASSERT(x.size() == 2);
+		CPPUNIT_ASSERT(x.back() == 6);
+		x = {7};
+		CPPUNIT_ASSERT(x.size() == 1);
+		CPPUNIT_ASSERT(x.front() == 7);
+		Counters::reset();
+		C y = {Counted(1), Counted(2), Counted(3)};
+		CPPUNIT_ASSERT(Counters::allocations == 1);
+	}
+#endif
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestAssign);
+	CPPUNIT_TEST(test_constructor_1);
+	CPPUNIT_TEST(test_constructor_2);
+	CPPUNIT_TEST(test_constructor_3);
+	CPPUNIT_TEST(test_assign_1);
+	CPPUNIT_TEST(test_allocation_1);
+	CPPUNIT_TEST(test_allocation_2);
+#if __cplusplus >= 201103L
+	CPPUNIT_TEST(test_initializer_list_1);
+#endif
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// --------------------
+// TestIncrementalDeque
+/**
+ * Worst-case bounds of MyIncrementalDeque, checked per operation by counting
+ */
+struct TestIncrementalDeque : CppUnit::TestFixture {
+	typedef MyIncrementalDeque<Counted, CountingAllocator<Counted> > C;
+
+	// every operation copies at most step pending elements, the element it
+	// adds, and the caller's value when it has to grow first
+	static bool bounded () {
+		return Counters::copies <= C::step + 2 &&
+			Counters::allocations <= 1 && Counters::deallocations <= 1;}
+
+	// ---------
+	// push_back
+	void test_push_back_1 () {
+		C x;
+		for (int i = 0; i < 100000; ++i) {
+			Counters::reset();
+			x.push_back(Counted(i));
+			CPPUNIT_ASSERT(bounded());}
+		for (int i = 0; i < 100000; i += 999)
+			CPPUNIT_ASSERT(x[i].v == i);
+	}
+
+	// --------
+	// push_pop
+	void test_push_pop_1 () {
+		std::srand(11);
+		std::deque<int> d;
+		C x;
+		for (int i = 0; i < 20000; ++i) {
+			const int v = std::rand();
+			Counters::reset();
+			switch (std::rand() % 5) {
+				case 0:
+				case 1:
+					d.push_back(v);
+					x.push_back(Counted(v));
+					break;
+				case 2:
+					d.push_front(v);
+					x.push_front(Counted(v));
+					break;
+				case 3:
+					if (!d.empty()) {
+						d.pop_back();
+						x.pop_back();}
+					break;
+				default:
+					if (!d.empty()) {
+						d.pop_front();
+						x.pop_front();}}
+			CPPUNIT_ASSERT(bounded());
+			CPPUNIT_ASSERT(x.size() == d.size());
+			if (!d.empty()) {
+				CPPUNIT_ASSERT(x.front().v == d.front());
+				CPPUNIT_ASSERT(x.back().v == d.back());
+				CPPUNIT_ASSERT(x[d.size() / 2].v == d[d.size() / 2]);}}
+	}
+
+	// -------
+	// pending
+	void test_pending_1 () {
+		MyIncrementalDeque<int> x;
+		int n = 0;
+		while (!x.pending())
+			x.push_back(n++);
+		CPPUNIT_ASSERT(x.pending() + MyIncrementalDeque<int>::step == (unsigned)n - 1);
+		CPPUNIT_ASSERT(x.back() == n - 1);
+		int ops = 0;
+		while (x.pending()) {
+			const unsigned p = x.pending();
+			x.push_front(-1);
+			x.pop_front();
+			ops += 2;
+			CPPUNIT_ASSERT(p - x.pending() <= 2 * MyIncrementalDeque<int>::step);}
+		CPPUNIT_ASSERT(ops <= n);
+		for (int i = 0; i < n; ++i)
+			CPPUNIT_ASSERT(x[i] == i);
+	}
+
+	// -----
+	// clear
+	void test_clear_1 () {
+		Counters::reset();
+		{
+		C x;
+		while (!x.pending())
+			x.push_back(Counted(1));
+		C y(x);
+		x.push_front(Counted(2));
+		CPPUNIT_ASSERT(x.pending());
+		x.swap(y);
+		CPPUNIT_ASSERT(y.pending());
+		CPPUNIT_ASSERT(y.front().v == 2);
+		y.clear();
+		CPPUNIT_ASSERT(!y.pending());
+		CPPUNIT_ASSERT(y.empty());
+		y.push_back(Counted(3));
+		CPPUNIT_ASSERT(y.back().v == 3);
+		}
+		CPPUNIT_ASSERT(Counters::constructions + Counters::copies == Counters::destructions);
+		CPPUNIT_ASSERT(Counters::allocations == Counters::deallocations);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestIncrementalDeque);
+	CPPUNIT_TEST(test_push_back_1);
+	CPPUNIT_TEST(test_push_pop_1);
+	CPPUNIT_TEST(test_pending_1);
+	CPPUNIT_TEST(test_clear_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// ----------
+// TestWindow
+struct TestWindow : CppUnit::TestFixture {
+
+	// ---
+	// min
+	void test_min_1 () {
+		MyMonotonicWindow<int> x(3);
+		const int a[] = {5, 3, 4, 6, 7, 1, 2};
+		const int m[] = {5, 3, 3, 3, 4, 1, 1};
+		for (int i = 0; i < 7; ++i) {
+			x.push(a[i]);
+			CPPUNIT_ASSERT(x.value() == m[i]);}
+		CPPUNIT_ASSERT(x.size() == 3);
+	}
+
+	void test_min_2 () {
+		std::srand(0);
+		std::deque<int> d;
+		MyMonotonicWindow<int> x(50);
+		for (int i = 0; i < 5000; ++i) {
+			const int v = std::rand() % 1000;
+			x.push(v);
+			d.push_back(v);
+			if (d.size() > 50)
+				d.pop_front();
+			CPPUNIT_ASSERT(x.value() == *std::min_element(d.begin(), d.end()));}
+	}
+
+	// ---
+	// max
+	void test_max_1 () {
+		std::srand(1);
+		std::deque<int> d;
+		MyMonotonicWindow<int, std::greater<int> > x(17);
+		for (int i = 0; i < 5000; ++i) {
+			const int v = std::rand() % 100;
+			x.push(v);
+			d.push_back(v);
+			if (d.size() > 17)
+				d.pop_front();
+			CPPUNIT_ASSERT(x.value() == *std::max_element(d.begin(), d.end()));}
+	}
+
+	// ------
+	// expire
+	void test_expire_1 () {
+		MyMonotonicWindow<int> x(0, 10);
+		x.push(1, 100);
+		x.push(5, 105);
+		x.push(7, 109);
+		CPPUNIT_ASSERT(x.value() == 1);
+		x.push(9, 111);
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(x.value() == 5);
+		x.expire(110);
+		CPPUNIT_ASSERT(x.size() == 1);
+		CPPUNIT_ASSERT(x.value() == 9);
+	}
+
+	void test_expire_2 () {
+		MyAggregateWindow<int> x(0, 10);
+		x.push(1, 100);
+		x.push(5, 105);
+		x.push(7, 109);
+		CPPUNIT_ASSERT(x.value() == 13);
+		x.push(9, 111);
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(x.value() == 21);
+		x.expire(110);
+		CPPUNIT_ASSERT(x.value() == 9);
+	}
+
+	// -----
+	// batch
+	void test_batch_1 () {
+		const int a[] = {4, 8, 2, 6, 9, 3};
+		MyMonotonicWindow<int> x(4);
+		MyAggregateWindow<int> y(4);
+		x.ingest(a, a + 6);
+		y.ingest(a, a + 6);
+		CPPUNIT_ASSERT(x.size() == 4);
+		CPPUNIT_ASSERT(x.value() == 2);
+		CPPUNIT_ASSERT(y.size() == 4);
+		CPPUNIT_ASSERT(y.value() == 20);
+	}
+
+	// ---
+	// sum
+	void test_sum_1 () {
+		std::srand(2);
+		std::deque<int> d;
+		MyAggregateWindow<int> x(100);
+		for (int i = 0; i < 5000; ++i) {
+			const int v = std::rand() % 1000;
+			x.push(v);
+			d.push_back(v);
+			if (d.size() > 100)
+				d.pop_front();
+			int t = 0;
+			for (std::deque<int>::size_type j = 0; j != d.size(); ++j)
+				t += d[j];
+			CPPUNIT_ASSERT(x.value() == t);}
+	}
+
+	// ----
+	// fold
+	void test_fold_1 () {
+		MyAggregateWindow<std::string> x(3);
+		x.push("a");
+		x.push("b");
+		CPPUNIT_ASSERT(x.value() == "ab");
+		x.push("c");
+		x.push("d");
+		CPPUNIT_ASSERT(x.value() == "bcd");
+		x.pop();
+		x.push("e");
+		CPPUNIT_ASSERT(x.value() == "cde");
+		x.keep_last(1);
+		CPPUNIT_ASSERT(x.value() == "e");
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestWindow);
+	CPPUNIT_TEST(test_min_1);
+	CPPUNIT_TEST(test_min_2);
+	CPPUNIT_TEST(test_max_1);
+	CPPUNIT_TEST(test_expire_1);
+	CPPUNIT_TEST(test_expire_2);
+	CPPUNIT_TEST(test_batch_1);
+	CPPUNIT_TEST(test_sum_1);
+	CPPUNIT_TEST(test_fold_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// -------------------
+// TestCompressedDeque
+struct TestCompressedDeque : CppUnit::TestFixture {
+
+	// ---------
+	// push_back
+	void test_push_back_1 () {
+		MyCompressedDeque<long, 4> x;
+		for (long i = 0; i < 30; ++i)
+			x.push_back(1000 + 3 * i);
+		CPPUNIT_ASSERT(x.size() == 30);
+		CPPUNIT_ASSERT(x.front() == 1000);
+		CPPUNIT_ASSERT(x.back() == 1087);
+		for (long i = 29; i >= 0; --i)
+			CPPUNIT_ASSERT(x[i] == 1000 + 3 * i);
+	}
+
+	void test_push_back_2 () {
+		MyCompressedDeque<long, 8> x;
+		const long a[] = {LONG_MIN, LONG_MAX, 0, -1, LONG_MAX, LONG_MIN, 7, -7, 1, 2};
+		for (int r = 0; r < 5; ++r)
+			for (int i = 0; i < 10; ++i)
+				x.push_back(a[i]);
+		for (int i = 0; i < 50; ++i)
+			CPPUNIT_ASSERT(x[i] == a[i % 10]);
+	}
+
+	void test_push_back_3 () {
+		MyCompressedDeque<unsigned char, 16> x;
+		for (int i = 0; i < 1000; ++i)
+			x.push_back((unsigned char)(i * 7));
+		for (int i = 0; i < 1000; ++i)
+			CPPUNIT_ASSERT(x[i] == (unsigned char)(i * 7));
+	}
+
+	// --------
+	// push_pop
+	void test_push_pop_1 () {
+		std::srand(3);
+		std::deque<int> d;
+		MyCompressedDeque<int, 4> x;
+		for (int i = 0; i < 5000; ++i) {
+			const int v = std::rand() % 64 - 32;
+			switch (std::rand() % 4) {
+				case 0:
+					d.push_back(v);
+					x.push_back(v);
+					break;
+				case 1:
+					d.push_front(v);
+					x.push_front(v);
+					break;
+				case 2:
+					if (!d.empty()) {
+						d.pop_back();
+						x.pop_back();}
+					break;
+				default:
+					if (!d.empty()) {
+						d.pop_front();
+						x.pop_front();}}
+			CPPUNIT_ASSERT(x.size() == d.size());
+			if (!d.empty()) {
+				CPPUNIT_ASSERT(x.front() == d.front());
+				CPPUNIT_ASSERT(x.back() == d.back());
+				CPPUNIT_ASSERT(x[d.size() / 2] == d[d.size() / 2]);}}
+		CPPUNIT_ASSERT(std::equal(d.begin(), d.end(), x.begin()));
+	}
+
+	// -----
+	// bytes
+	void test_bytes_1 () {
+		MyCompressedDeque<long> x;
+		long t = 1342483200000L;
+		for (int i = 0; i < 100000; ++i) {
+			t += 1000 + std::rand() % 50;
+			x.push_back(t);}
+		CPPUNIT_ASSERT(x.bytes() * 4 < x.size() * sizeof(long));
+	}
+
+	void test_bytes_2 () {
+		// spare capacity is allocated, so it counts
+		MyCompressedDeque<long, 4> x;
+		for (long i = 0; i < 100; ++i)
+			x.push_back(i);
+		const std::size_t b = x.bytes();
+		for (int i = 0; i < 90; ++i)
+			x.pop_front();
+		const std::size_t c = x.bytes();
+		CPPUNIT_ASSERT(c >= b);
+		x.clear();
+		CPPUNIT_ASSERT(x.empty());
+		CPPUNIT_ASSERT(x.bytes() == c);
+	}
+
+	// ----------
+	// hysteresis
+	void test_hysteresis_1 () {
+		// an end going back and forth across a block boundary seals and
+		// unseals nothing
+		MyCompressedDeque<int, 4> x;
+		for (int i = 0; i < 20; ++i)
+			x.push_back(i);
+		CPPUNIT_ASSERT(x.blocks() == 4);
+		for (int i = 0; i < 5; ++i)
+			x.pop_back();
+		CPPUNIT_ASSERT(x.blocks() == 3);
+		for (int i = 0; i < 100; ++i) {
+			x.push_back(i);
+			CPPUNIT_ASSERT(x.blocks() == 3);
+			x.pop_back();
+			CPPUNIT_ASSERT(x.blocks() == 3);}
+		for (int i = 0; i < 4; ++i)
+			x.push_back(15 + i);
+		CPPUNIT_ASSERT(x.blocks() == 3);
+		x.push_back(19);
+		CPPUNIT_ASSERT(x.blocks() == 4);
+		for (int i = 0; i < 100; ++i) {
+			x.pop_back();
+			CPPUNIT_ASSERT(x.blocks() == 4);
+			x.push_back(19);
+			CPPUNIT_ASSERT(x.blocks() == 4);}
+		for (int i = 0; i < 20; ++i)
+			CPPUNIT_ASSERT(x[i] == i);
+	}
+
+	void test_hysteresis_2 () {
+		MyCompressedDeque<int, 4> x;
+		for (int i = 0; i < 20; ++i)
+			x.push_front(-i);
+		CPPUNIT_ASSERT(x.blocks() == 4);
+		for (int i = 0; i < 5; ++i)
+			x.pop_front();
+		CPPUNIT_ASSERT(x.blocks() == 3);
+		for (int i = 0; i < 100; ++i) {
+			x.push_front(7);
+			x.pop_front();
+			CPPUNIT_ASSERT(x.blocks() == 3);}
+		CPPUNIT_ASSERT(x.size() == 15);
+		for (int i = 0; i < 15; ++i)
+			CPPUNIT_ASSERT(x[i] == i - 14);
+	}
+
+	// ----
+	// copy
+	void test_copy_1 () {
+		MyCompressedDeque<long, 8> x;
+		for (long i = 0; i < 100; ++i)
+			x.push_front(i * i);
+		MyDeque<long> y(100);
+		x.copy(y.begin());
+		for (long i = 0; i < 100; ++i)
+			CPPUNIT_ASSERT(y[i] == (99 - i) * (99 - i));
+		MyCompressedDeque<long, 8> z(x);
+		CPPUNIT_ASSERT(z == x);
+		z.pop_front();
+		CPPUNIT_ASSERT(z < x);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestCompressedDeque);
+	CPPUNIT_TEST(test_push_back_1);
+	CPPUNIT_TEST(test_push_back_2);
+	CPPUNIT_TEST(test_push_back_3);
+	CPPUNIT_TEST(test_push_pop_1);
+	CPPUNIT_TEST(test_bytes_1);
+	CPPUNIT_TEST(test_bytes_2);
+	CPPUNIT_TEST(test_hysteresis_1);
+	CPPUNIT_TEST(test_hysteresis_2);
+	CPPUNIT_TEST(test_copy_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// ------------
+// TestBitDeque
+struct TestBitDeque : CppUnit::TestFixture {
+	typedef MyBitDeque<> C;
+
+	// --------
+	// push_pop
+	void test_push_pop_1 () {
+		std::srand(13);
+		std::deque<bool> d;
+		C x;
+		for (int i = 0; i < 20000; ++i) {
+			const bool v = std::rand() % 3 == 0;
+			switch (std::rand() % 4) {
+				case 0:
+					d.push_back(v);
+					x.push_back(v);
+					break;
+				case 1:
+					d.push_front(v);
+					x.push_front(v);
+					break;
+				case 2:
+					if (!d.empty()) {
+						d.pop_back();
+						x.pop_back();}
+					break;
+				default:
+					if (!d.empty()) {
+						d.pop_front();
+						x.pop_front();}}
+			CPPUNIT_ASSERT(x.size() == d.size());
+			if (!d.empty()) {
+				CPPUNIT_ASSERT(x.front() == d.front());
+				CPPUNIT_ASSERT(x.back() == d.back());}}
+		const C& y = x;
+		CPPUNIT_ASSERT(std::equal(d.begin(), d.end(), y.begin()));
+	}
+
+	// ----
+	// word
+	void test_word_1 () {
+		C x;
+		x.push_back(true);
+		x.push_back_word(0xF0UL, 8);
+		x.push_front_word(0x5UL, 3);
+		// 1 0 1 | 1 | 0 0 0 0 1 1 1 1
+		CPPUNIT_ASSERT(x.size() == 12);
+		CPPUNIT_ASSERT(x.read(0, 12) == 0xF0DUL);
+		x.push_front_word(~0UL);
+		x.push_back_word(~0UL);
+		CPPUNIT_ASSERT(x.size() == 140);
+		CPPUNIT_ASSERT(x.count() == 64 + 7 + 64);
+		CPPUNIT_ASSERT(x.read(64, 12) == 0xF0DUL);
+		CPPUNIT_ASSERT(x.read(70) == (0xF0DUL >> 6 | ~0UL << 6));
+		x.pop_front(65);
+		x.pop_back(64);
+		CPPUNIT_ASSERT(x.size() == 11);
+		CPPUNIT_ASSERT(x.read(0, 11) == 0x786UL);
+		x.pop_back(11);
+		CPPUNIT_ASSERT(x.empty());
+	}
+
+	void test_word_2 () {
+		std::srand(17);
+		std::deque<bool> d;
+		C x;
+		for (int i = 0; i < 2000; ++i) {
+			const unsigned long w = ((unsigned long)std::rand() << 32) ^ std::rand();
+			const std::size_t n = std::rand() % 65;
+			if (std::rand() % 2) {
+				x.push_back_word(w, n);
+				for (std::size_t j = 0; j < n; ++j)
+					d.push_back((w >> j) & 1);}
+			else {
+				x.push_front_word(w, n);
+				for (std::size_t j = n; j > 0; --j)
+					d.push_front((w >> (j - 1)) & 1);}
+			if (std::rand() % 2) {
+				const std::size_t k = std::min(d.size(), (std::size_t)std::rand() % 80);
+				if (std::rand() % 2) {
+					x.pop_back(k);
+					d.erase(d.end() - k, d.end());}
+				else {
+					x.pop_front(k);
+					d.erase(d.begin(), d.begin() + k);}}
+			CPPUNIT_ASSERT(x.size() == d.size());}
+		CPPUNIT_ASSERT(std::equal(d.begin(), d.end(), x.begin()));
+	}
+
+	// -----
+	// count
+	void test_count_1 () {
+		C x;
+		for (int i = 0; i < 1000; ++i)
+			x.push_front(i % 7 == 0);
+		for (int b = 0; b < 1000; b += 37)
+			for (int e = b; e <= 1000; e += 53) {
+				const std::size_t n = std::count(x.begin() + b, x.begin() + e, true);
+				CPPUNIT_ASSERT(x.count(b, e) == n);}
+		CPPUNIT_ASSERT(x.count() == 143);
+	}
+
+	// ----------
+	// find_first
+	void test_find_first_1 () {
+		C x(1000);
+		CPPUNIT_ASSERT(x.find_first() == 1000);
+		x[700] = true;
+		x[130] = true;
+		CPPUNIT_ASSERT(x.find_first() == 130);
+		CPPUNIT_ASSERT(x.find_first(131, 1000) == 700);
+		CPPUNIT_ASSERT(x.find_first(131, 700) == 700);
+		CPPUNIT_ASSERT(x.find_first(0, 130) == 130);
+		x.pop_front(131);
+		CPPUNIT_ASSERT(x.find_first() == 569);
+	}
+
+	// -----
+	// proxy
+	void test_proxy_1 () {
+		C x(5, true);
+		x[1] = false;
+		x[3] = x[1];
+		x[4].flip();
+		CPPUNIT_ASSERT(x.count() == 2);
+		CPPUNIT_ASSERT(x[0] && x[2]);
+		*(x.begin() + 1) = true;
+		CPPUNIT_ASSERT(x.at(1));
+		x.insert(x.begin() + 2, false);
+		CPPUNIT_ASSERT(x.size() == 6);
+		CPPUNIT_ASSERT(!x[2] && x[3]);
+		x.erase(x.begin());
+		CPPUNIT_ASSERT(x.size() == 5);
+		CPPUNIT_ASSERT(x[0] && !x[1]);
+		try {
+			x.at(5);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::out_of_range&) {}
+	}
+
+	// -------
+	// compare
+	void test_compare_1 () {
+		C x(200, true);
+		C y(x);
+		y.push_front(true);
+		y.pop_back();
+		CPPUNIT_ASSERT(x == y);
+		y[150] = false;
+		CPPUNIT_ASSERT(!(x == y));
+		CPPUNIT_ASSERT(y < x);
+		x.swap(y);
+		CPPUNIT_ASSERT(x < y);
+		x.resize(70, true);
+		CPPUNIT_ASSERT(x.count() == 70);
+		x.resize(300);
+		CPPUNIT_ASSERT(x.count() == 70);
+		x.clear();
+		CPPUNIT_ASSERT(x.empty());
+	}
+
+	// -----------
+	// constructor
+	void test_constructor_1 () {
+		const bool a[] = {true, false, false, true, true};
+		const C x(a, a + 5);
+		CPPUNIT_ASSERT(x.size() == 5);
+		CPPUNIT_ASSERT(std::equal(a, a + 5, x.begin()));
+		const C y(3, 1);
+		CPPUNIT_ASSERT(y.size() == 3);
+		CPPUNIT_ASSERT(y.count() == 3);
+	}
+
+	void test_constructor_2 () {
+		// MyDeque<bool> is the primary template, so braces list elements
+		MyDeque<bool> x(2, true);
+		CPPUNIT_ASSERT(x.size() == 2);
+		CPPUNIT_ASSERT(x.data() == &x[0]);
+#if __cplusplus >= 201103L
+		MyDeque<bool> y{true, false};
+		CPPUNIT_ASSERT(y.size() == 2);
+		CPPUNIT_ASSERT(y[0] && !y[1]);
+		C z{true, false};
+		CPPUNIT_ASSERT(z.size() == 2);
+		CPPUNIT_ASSERT(z[0] && !z[1]);
+#endif
+	}
+
+	// ------
+	// assign
+	void test_assign_1 () {
+		C x(100, true);
+		const bool a[] = {false, true, false};
+		x.assign(a, a + 3);
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(!x[0] && x[1] && !x[2]);
+		x.assign(70, true);
+		CPPUNIT_ASSERT(x.size() == 70);
+		CPPUNIT_ASSERT(x.count() == 70);
+		x.assign(2, 0);
+		CPPUNIT_ASSERT(x.size() == 2);
+		CPPUNIT_ASSERT(x.count() == 0);
+#if __cplusplus >= 201103L
+		x.assign({true, true, false});
+		CPPUNIT_ASSERT(x.size() == 3);
+		CPPUNIT_ASSERT(x.count() == 2);
+		x = {false};
+		CPPUNIT_ASSERT(x.size() == 1);
+		CPPUNIT_ASSERT(!x[0]);
+#endif
+	}
+
+	// --------
+	// iterator
+	void test_iterator_1 () {
+		C x(130);
+		CPPUNIT_ASSERT(x.end() - x.begin() == 130);
+		CPPUNIT_ASSERT((x.begin() + 70) - (x.begin() + 5) == 65);
+		const C& y = x;
+		CPPUNIT_ASSERT(y.begin() - y.end() == -130);
+		CPPUNIT_ASSERT(std::distance(y.begin(), y.end()) == 130);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestBitDeque);
+	CPPUNIT_TEST(test_push_pop_1);
+	CPPUNIT_TEST(test_word_1);
+	CPPUNIT_TEST(test_word_2);
+	CPPUNIT_TEST(test_count_1);
+	CPPUNIT_TEST(test_find_first_1);
+	CPPUNIT_TEST(test_proxy_1);
+	CPPUNIT_TEST(test_compare_1);
+	CPPUNIT_TEST(test_constructor_1);
+	CPPUNIT_TEST(test_constructor_2);
+	CPPUNIT_TEST(test_assign_1);
+	CPPUNIT_TEST(test_iterator_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// --------
+// shm_name
+/**
+ * Returns a segment name no other test run is using
+ */
+std::string shm_name (const char* tag) {
+	std::ostringstream out;
+	out << "/TestDeque-" << getpid() << "-" << tag;
+	return out.str();}
+
+// ---------------
+// TestSharedDeque
+struct TestSharedDeque : CppUnit::TestFixture {
+
+	// ----------
+	// offset_ptr
+	struct node {
+		MyOffsetPtr<node> next;
+		MyOffsetPtr<int> p;
+		MyOffsetPtr<int> q;
+		int v;};
+
+	// storage aligned for a node, so its bytes can be moved as a mapping's are
+	union storage {
+		char c[sizeof(node)];
+		std::ptrdiff_t align;};
+
+	void test_offset_ptr_1 () {
+		storage a;
+		storage b;
+		node* x = new (a.c) node;
+		x->v = 7;
+		x->p = &x->v;
+		x->q = x->p;
+		x->next = x;
+		CPPUNIT_ASSERT(x->q.get() == &x->v);
+		CPPUNIT_ASSERT(x->next.get() == x);
+		std::memcpy(b.c, a.c, sizeof(node));
+		node* y = reinterpret_cast<node*>(b.c);
+		CPPUNIT_ASSERT(y->p.get() == &y->v);
+		CPPUNIT_ASSERT(y->q.get() == &y->v);
+		CPPUNIT_ASSERT(*y->p == 7);
+		CPPUNIT_ASSERT(y->next.get() == y);
+		y->next = 0;
+		CPPUNIT_ASSERT(!y->next.get());
+		CPPUNIT_ASSERT(!MyOffsetPtr<int>().get());
+	}
+
+	// -----
+	// arena
+	void test_arena_1 () {
+		const std::string name = shm_name("arena");
+		MySharedMemory m(name.c_str(), 1 << 16);
+		MySharedArena* a = m.arena();
+		const std::size_t n = a->available();
+		void* p[10];
+		for (int i = 0; i < 10; ++i) {
+			p[i] = a->allocate(1000 + i);
+			CPPUNIT_ASSERT(reinterpret_cast<std::size_t>(p[i]) % 16 == 0);}
+		CPPUNIT_ASSERT(a->available() < n - 10000);
+		for (int i = 0; i < 10; i += 2)
+			a->deallocate(p[i]);
+		for (int i = 9; i > 0; i -= 2)
+			a->deallocate(p[i]);
+		CPPUNIT_ASSERT(a->available() == n);
+		a->deallocate(a->allocate(n - 64));
+		try {
+			a->allocate(n);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::bad_alloc&) {}
+		MySharedMemory::remove(name.c_str());
+	}
+
+	// --------
+	// push_pop
+	void test_push_pop_1 () {
+		const std::string name = shm_name("push_pop");
+		MySharedMemory m(name.c_str(), 1 << 20);
+		MySharedDeque<int>* x = MySharedDeque<int>::create(m);
+		std::srand(7);
+		std::deque<int> d;
+		for (int i = 0; i < 5000; ++i) {
+			const int v = std::rand();
+			int w = 0;
+			switch (std::rand() % 4) {
+				case 0:
+					d.push_back(v);
+					x->push_back(v);
+					break;
+				case 1:
+					d.push_front(v);
+					x->push_front(v);
+					break;
+				case 2:
+					CPPUNIT_ASSERT(x->try_pop_back(w) == !d.empty());
+					if (!d.empty()) {
+						CPPUNIT_ASSERT(w == d.back());
+						d.pop_back();}
+					break;
+				default:
+					CPPUNIT_ASSERT(x->try_pop_front(w) == !d.empty());
+					if (!d.empty()) {
+						CPPUNIT_ASSERT(w == d.front());
+						d.pop_front();}}
+			CPPUNIT_ASSERT(x->size() == d.size());}
+		MySharedDeque<int>::dispose(m);
+		CPPUNIT_ASSERT(m.arena()->available() == m.arena()->capacity());
+		MySharedMemory::remove(name.c_str());
+	}
+
+	void test_push_pop_2 () {
+		const std::string name = shm_name("fifo");
+		MySharedMemory m(name.c_str(), 1 << 12);
+		MySharedDeque<long>* x = MySharedDeque<long>::create(m);
+		long v = 0;
+		for (long i = 0; i < 100000; ++i) {
+			x->push_back(i);
+			if (i >= 10) {
+				CPPUNIT_ASSERT(x->try_pop_front(v));
+				CPPUNIT_ASSERT(v == i - 10);}}
+		CPPUNIT_ASSERT(x->size() == 10);
+		MySharedDeque<long>::dispose(m);
+		MySharedMemory::remove(name.c_str());
+	}
+
+	// -------
+	// mapping
+	void test_mapping_1 () {
+		const std::string name = shm_name("mapping");
+		MySharedMemory m(name.c_str(), 1 << 16);
+		MySharedMemory n(name.c_str());
+		CPPUNIT_ASSERT(m.arena() != n.arena());
+		CPPUNIT_ASSERT(n.size() == m.size());
+		MySharedDeque<int>* x = MySharedDeque<int>::create(m);
+		MySharedDeque<int>* y = MySharedDeque<int>::attach(n);
+		for (int i = 0; i < 100; ++i)
+			x->push_front(i);
+		CPPUNIT_ASSERT(y->size() == 100);
+		int v = 0;
+		CPPUNIT_ASSERT(y->try_pop_back(v));
+		CPPUNIT_ASSERT(v == 0);
+		CPPUNIT_ASSERT(y->try_pop_front(v));
+		CPPUNIT_ASSERT(v == 99);
+		y->push_back(-1);
+		CPPUNIT_ASSERT(x->try_pop_back(v));
+		CPPUNIT_ASSERT(v == -1);
+		CPPUNIT_ASSERT(x->size() == 98);
+		MySharedDeque<int>::dispose(n);
+		MySharedMemory::remove(name.c_str());
+	}
+
+	// -----
+	// close
+	void test_close_1 () {
+		const std::string name = shm_name("close");
+		MySharedMemory m(name.c_str(), 1 << 12);
+		MySharedDeque<int>* x = MySharedDeque<int>::create(m);
+		x->push_back(1);
+		x->close();
+		CPPUNIT_ASSERT(x->closed());
+		int v = 0;
+		CPPUNIT_ASSERT(x->pop_back(v));
+		CPPUNIT_ASSERT(v == 1);
+		CPPUNIT_ASSERT(!x->pop_front(v));
+		CPPUNIT_ASSERT(!x->try_pop_front(v));
+		MySharedDeque<int>::dispose(m);
+		MySharedMemory::remove(name.c_str());
+	}
+
+	// -------
+	// process
+	void test_process_1 () {
+		const std::string name = shm_name("process");
+		MySharedMemory m(name.c_str(), 1 << 20);
+		MySharedDeque<int>* x = MySharedDeque<int>::create(m);
+		const pid_t pid = fork();
+		CPPUNIT_ASSERT(pid != -1);
+		if (pid == 0) {
+			int status = 1;
+			try {
+				MySharedMemory n(name.c_str());
+				MySharedDeque<int>* y = MySharedDeque<int>::attach(n);
+				for (int i = 0; i < 20000; ++i)
+					y->push_back(i);
+				status = 0;}
+			catch (...) {}
+			x->close();
+			_exit(status);}
+		int v = 0;
+		int i = 0;
+		while (x->pop_front(v)) {
+			CPPUNIT_ASSERT(v == i);
+			++i;}
+		CPPUNIT_ASSERT(i == 20000);
+		int status = -1;
+		CPPUNIT_ASSERT(waitpid(pid, &status, 0) == pid);
+		CPPUNIT_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+		MySharedDeque<int>::dispose(m);
+		MySharedMemory::remove(name.c_str());
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestSharedDeque);
+	CPPUNIT_TEST(test_offset_ptr_1);
+	CPPUNIT_TEST(test_arena_1);
+	CPPUNIT_TEST(test_push_pop_1);
+	CPPUNIT_TEST(test_push_pop_2);
+	CPPUNIT_TEST(test_mapping_1);
+	CPPUNIT_TEST(test_close_1);
+	CPPUNIT_TEST(test_process_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// ---------
+// temp_name
+/**
+ * Returns a file name no other test run is using
+ */
+std::string temp_name (const char* tag) {
+	std::ostringstream out;
+	out << "/tmp/TestDeque-" << getpid() << "-" << tag;
+	return out.str();}
+
+#ifdef __linux__
+// -----------
+// TestMapping
+struct TestMapping : CppUnit::TestFixture {
+	typedef MyMapping<int, std::allocator<int> > M;
+
+	// -------
+	// enabled
+	void test_enabled_1 () {
+		const std::size_t n = M::threshold / sizeof(int);
+		CPPUNIT_ASSERT(M::enabled);
+		typedef MyMapping<char*, std::allocator<char*> > P;
+		CPPUNIT_ASSERT(P::enabled);
+		typedef MyMapping<int, CountingAllocator<int> > Q;
+		typedef MyMapping<std::string, std::allocator<std::string> > R;
+		CPPUNIT_ASSERT(!Q::enabled);
+		CPPUNIT_ASSERT(!R::enabled);
+		CPPUNIT_ASSERT(!M::mapped(n - 1));
+		CPPUNIT_ASSERT(M::mapped(n));
+	}
+
+	// ----------
+	// reallocate
+	void test_reallocate_1 () {
+		std::allocator<int> a;
+		const std::size_t n = M::threshold / sizeof(int);
+		int* p = M::allocate(a, n);
+		for (std::size_t i = 0; i != n; ++i)
+			p[i] = i;
+		p = M::reallocate(a, p, n, 4 * n);
+		p[4 * n - 1] = -1;
+		for (std::size_t i = 0; i != n; ++i)
+			CPPUNIT_ASSERT(p[i] == (int)i);
+		M::deallocate(a, p, 4 * n);
+	}
+
+	void test_reallocate_2 () {
+		std::allocator<int> a;
+		const std::size_t n = M::threshold / sizeof(int);
+		int* p = M::allocate(a, 100);
+		for (int i = 0; i != 100; ++i)
+			p[i] = i;
+		p = M::reallocate(a, p, 100, n);
+		p[n - 1] = -1;
+		for (int i = 0; i != 100; ++i)
+			CPPUNIT_ASSERT(p[i] == i);
+		M::deallocate(a, p, n);
+		p = M::reallocate(a, 0, 0, n);
+		p[0] = 1;
+		M::deallocate(a, p, n);
+	}
+
+	// -----
+	// deque
+	void test_deque_1 () {
+		const int n = 1 << 20;
+		MyDeque<int> x;
+		MyMappingTally& t = MyMappingTally::get();
+		const MyMappingTally u = t;
+		while (!M::mapped(x.size() + 1))
+			x.push_back(x.size());
+		// crossing the threshold copies the heap buffer into a mapping once
+		x.push_back(x.size());
+		CPPUNIT_ASSERT(t.remaps == u.remaps);
+		CPPUNIT_ASSERT(t.copied > u.copied);
+		const MyMappingTally v = t;
+		for (int i = x.size(); i != n; ++i)
+			x.push_back(i);
+		for (int i = 1; i <= n / 4; ++i)
+			x.push_front(-i);
+		// every growth after that only remapped
+		CPPUNIT_ASSERT(t.remaps >= v.remaps + 2);
+		CPPUNIT_ASSERT(t.copied == v.copied);
+		CPPUNIT_ASSERT(x.size() == (std::size_t)n + n / 4);
+		for (int i = 0; i != n / 4; ++i)
+			CPPUNIT_ASSERT(x[i] == i - n / 4);
+		for (int i = 0; i != n; ++i)
+			CPPUNIT_ASSERT(x[n / 4 + i] == i);
+		x.resize(2 * n, 7);
+		CPPUNIT_ASSERT(x.back() == 7);
+		CPPUNIT_ASSERT(x[n / 4 + n - 1] == n - 1);
+		MyDeque<int> y(x);
+		CPPUNIT_ASSERT(x == y);
+	}
+
+	// ------
+	// vector
+	void test_vector_1 () {
+		const int n = 1 << 20;
+		my_vector<int> x;
+		for (int i = 0; i != n; ++i)
+			x.push_back(i);
+		x.reserve(3 * n);
+		CPPUNIT_ASSERT(x.capacity() == (std::size_t)3 * n);
+		CPPUNIT_ASSERT(x.size() == (std::size_t)n);
+		for (int i = 0; i != n; ++i)
+			CPPUNIT_ASSERT(x[i] == i);
+		my_vector<int> y(x);
+		CPPUNIT_ASSERT(x == y);
+		y.resize(10);
+		y.reserve(20);
+		CPPUNIT_ASSERT(y.back() == 9);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestMapping);
+	CPPUNIT_TEST(test_enabled_1);
+	CPPUNIT_TEST(test_reallocate_1);
+	CPPUNIT_TEST(test_reallocate_2);
+	CPPUNIT_TEST(test_deque_1);
+	CPPUNIT_TEST(test_vector_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+#endif
+
+// ----------------
+// StringSerializer
+/**
+ * Writes a string as its length and then its characters
+ */
+struct StringSerializer {
+	void write (std::ostream& out, const std::string& v) {
+		out << v.size() << ' ' << v;}
+
+	std::string read (std::istream& in) {
+		std::size_t n = 0;
+		in >> n;
+		in.get();
+		std::string v(n, ' ');
+		if (n)
+			in.read(&v[0], n);
+		return v;}};
+
+// -------------
+// UnseekableBuf
+/**
+ * Serves a string the way a pipe would, without seeking
+ */
+struct UnseekableBuf : std::streambuf {
+	std::string _s;
+
+	explicit UnseekableBuf (const std::string& s) :
+			_s(s + ' ') {
+		setg(&_s[0], &_s[0], &_s[0] + s.size());}};
+
+// ------------
+// TestSnapshot
+struct TestSnapshot : CppUnit::TestFixture {
+
+	// ---------
+	// save_load
+	void test_save_load_1 () {
+		MyDeque<int> x;
+		for (int i = 0; i != 1000; ++i)
+			x.push_front(i);
+		std::stringstream s;
+		x.save(s);
+		MyDeque<int> y(5, 2);
+		y.load(s);
+		CPPUNIT_ASSERT(x == y);
+		CPPUNIT_ASSERT(s.peek() == EOF);
+	}
+
+	void test_save_load_2 () {
+		const int n = 3 << 20;
+		MyDeque<double> x(n);
+		for (int i = 0; i != n; ++i)
+			x[i] = i / 4.0;
+		std::stringstream s;
+		x.save(s);
+		CPPUNIT_ASSERT(s.str().size() == MySnapshot::size + n * sizeof(double));
+		MyDeque<double> y;
+		y.load(s);
+		CPPUNIT_ASSERT(x == y);
+		y.push_back(-1);
+		CPPUNIT_ASSERT(y[n - 1] == (n - 1) / 4.0);
+	}
+
+	void test_save_load_3 () {
+		MyDeque<std::string> x;
+		x.push_back("abc");
+		x.push_back("");
+		x.push_back("two words\n");
+		x.push_front(std::string(5000, 'z'));
+		std::stringstream s;
+		x.save(s, StringSerializer());
+		MyDeque<std::string> y(3, "old");
+		y.load(s, StringSerializer());
+		CPPUNIT_ASSERT(x == y);
+		MyDeque<std::string> z;
+		std::stringstream t;
+		z.save(t, StringSerializer());
+		y.load(t, StringSerializer());
+		CPPUNIT_ASSERT(y.empty());
+	}
+
+	void test_save_load_4 () {
+		// payloads of several blocks, from streams that cannot seek
+		MyDeque<std::string> x;
+		for (int i = 0; i != 3000; ++i)
+			x.push_back(std::string(1000 + i % 7, char('a' + i % 26)));
+		std::stringstream s;
+		x.save(s, StringSerializer());
+		CPPUNIT_ASSERT(s.str().size() > 2 * MySnapshot::block);
+		UnseekableBuf p(s.str());
+		std::istream pipe(&p);
+		MyDeque<std::string> y;
+		y.load(pipe, StringSerializer());
+		CPPUNIT_ASSERT(x == y);
+		MyDeque<long> z;
+		for (long i = 0; i != 500000; ++i)
+			z.push_front(i * 3);
+		std::stringstream t;
+		z.save(t);
+		UnseekableBuf q(t.str());
+		std::istream raw(&q);
+		MyDeque<long> w(4, 4);
+		w.load(raw);
+		CPPUNIT_ASSERT(z == w);
+	}
+
+	// -----
+	// error
+	void test_error_1 () {
+		MyDeque<int> x(100, 7);
+		std::stringstream s;
+		x.save(s);
+		std::string b = s.str();
+		b[MySnapshot::size + 10] ^= 1;
+		MyDeque<int> y(3, 1);
+		std::istringstream in(b);
+		try {
+			y.load(in);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error& e) {
+			CPPUNIT_ASSERT(std::strcmp(e.what(), "deque::load: bad checksum") == 0);}
+		CPPUNIT_ASSERT(y == MyDeque<int>(3, 1));
+	}
+
+	void test_error_2 () {
+		MyDeque<int> x(100, 7);
+		std::stringstream s;
+		x.save(s);
+		const std::string b = s.str();
+		MyDeque<long> y;
+		std::istringstream in(b);
+		try {
+			y.load(in);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		MyDeque<int> z;
+		std::istringstream t(b.substr(0, b.size() - 1));
+		try {
+			z.load(t);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		std::istringstream u("text");
+		try {
+			z.load(u);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		std::istringstream v(b);
+		try {
+			MyDeque<std::string>().load(v, StringSerializer());
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		CPPUNIT_ASSERT(z.empty());
+	}
+
+	void test_error_3 () {
+		// count * element and size + bytes both wrap, and would pass
+		std::stringstream s;
+		MySnapshot(4, MySnapshot::raw, (uint64_t(1) << 62) - 8, ~uint64_t(0) - 31).write(s);
+		s << std::string(64, '\0');
+		const std::string b = s.str();
+		CPPUNIT_ASSERT(b.size() == 128);
+		MyDeque<int> x(2, 5);
+		std::istringstream in(b);
+		try {
+			x.load(in);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error& e) {
+			CPPUNIT_ASSERT(std::strcmp(e.what(), "deque::load: truncated snapshot") == 0);}
+		CPPUNIT_ASSERT(x == MyDeque<int>(2, 5));
+		const std::string name = temp_name("crafted.snapshot");
+		{
+		std::ofstream out(name.c_str(), std::ios::binary);
+		out << b;
+		}
+		try {
+			MySnapshotView<int> v(name.c_str());
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		std::remove(name.c_str());
+	}
+
+	void test_error_4 () {
+		// neither count nor bytes is allocated before it is checked
+		std::stringstream s;
+		MySnapshot(sizeof(std::string), 0, uint64_t(1) << 60, uint64_t(1) << 61).write(s);
+		s << "3 abc";
+		const std::string b = s.str();
+		MyDeque<std::string> x;
+		std::istringstream in(b);
+		try {
+			x.load(in, StringSerializer());
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		UnseekableBuf p(b);
+		std::istream pipe(&p);
+		try {
+			x.load(pipe, StringSerializer());
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		std::stringstream t;
+		MySnapshot(4, MySnapshot::raw, uint64_t(1) << 60, uint64_t(1) << 62).write(t);
+		t << std::string(64, '\0');
+		UnseekableBuf q(t.str());
+		std::istream raw(&q);
+		MyDeque<int> y;
+		try {
+			y.load(raw);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		CPPUNIT_ASSERT(x.empty() && y.empty());
+	}
+
+	// ----
+	// view
+	void test_view_1 () {
+		const std::string name = temp_name("view.snapshot");
+		MyDeque<long> x;
+		for (long i = 0; i != 100000; ++i)
+			x.push_back(i * i);
+		{
+		std::ofstream out(name.c_str(), std::ios::binary);
+		x.save(out);
+		}
+		{
+		MySnapshotView<long> v(name.c_str(), true);
+		CPPUNIT_ASSERT(v.size() == x.size());
+		CPPUNIT_ASSERT(std::equal(v.begin(), v.end(), x.begin()));
+		CPPUNIT_ASSERT(v[99999] == x[99999]);
+		}
+		try {
+			MySnapshotView<short> v(name.c_str());
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+		std::remove(name.c_str());
+		try {
+			MySnapshotView<long> v(name.c_str());
+			CPPUNIT_ASSERT(false);}
+		catch (const std::runtime_error&) {}
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestSnapshot);
+	CPPUNIT_TEST(test_save_load_1);
+	CPPUNIT_TEST(test_save_load_2);
+	CPPUNIT_TEST(test_save_load_3);
+	CPPUNIT_TEST(test_save_load_4);
+	CPPUNIT_TEST(test_error_1);
+	CPPUNIT_TEST(test_error_2);
+	CPPUNIT_TEST(test_error_3);
+	CPPUNIT_TEST(test_error_4);
+	CPPUNIT_TEST(test_view_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// --------------
+// TestTimerWheel
+struct TestTimerWheel : CppUnit::TestFixture {
+	typedef MyTimerWheel<int> W;
+
+	// -------
+	// advance
+	void test_advance_1 () {
+		W x;
+		MyDeque<int> e;
+		x.schedule(5, 50);
+		x.schedule(3, 30);
+		x.schedule(5, 51);
+		x.schedule(1, 10);
+		CPPUNIT_ASSERT(x.size() == 4);
+		CPPUNIT_ASSERT(x.advance(2, e) == 1);
+		CPPUNIT_ASSERT(x.advance(4, e) == 1);
+		CPPUNIT_ASSERT(x.advance(5, e) == 2);
+		CPPUNIT_ASSERT(x.empty());
+		CPPUNIT_ASSERT(x.now() == 5);
+		const int a[] = {10, 30, 50, 51};
+		CPPUNIT_ASSERT(e.size() == 4);
+		CPPUNIT_ASSERT(std::equal(a, a + 4, e.begin()));
+	}
+
+	void test_advance_2 () {
+		W x(100);
+		MyDeque<int> e;
+		x.schedule(50, 1);
+		x.schedule(100, 2);
+		CPPUNIT_ASSERT(x.advance(100, e) == 0);
+		CPPUNIT_ASSERT(x.advance(101, e) == 2);
+		CPPUNIT_ASSERT(x.advance(1000000, e) == 0);
+		CPPUNIT_ASSERT(x.now() == 1000000);
+	}
+
+	// -------
+	// cascade
+	void test_cascade_1 () {
+		W x(250);
+		MyDeque<int> e;
+		const W::time_type d[] = {70000, 300, 1L << 25, 65536, 65535, 256, 255, 16777216};
+		for (int i = 0; i != 8; ++i)
+			x.schedule(d[i], d[i]);
+		CPPUNIT_ASSERT(x.advance(65535, e) == 4);
+		CPPUNIT_ASSERT(x.advance(1L << 25, e) == 4);
+		const int a[] = {255, 256, 300, 65535, 65536, 70000, 16777216, 1 << 25};
+		CPPUNIT_ASSERT(std::equal(a, a + 8, e.begin()));
+	}
+
+	void test_cascade_2 () {
+		W x;
+		MyDeque<int> e;
+		std::vector<int> d;
+		std::srand(1);
+		for (int i = 0; i != 10000; ++i) {
+			d.push_back(1 + std::rand() % 300000);
+			x.schedule(d.back(), d.back());}
+		std::sort(d.begin(), d.end());
+		for (W::time_type t = 0; t < 300000; t += 997)
+			x.advance(t, e);
+		x.advance(300000, e);
+		CPPUNIT_ASSERT(e.size() == d.size());
+		CPPUNIT_ASSERT(std::equal(d.begin(), d.end(), e.begin()));
+	}
+
+	void test_overflow_1 () {
+		if (sizeof(W::time_type) * CHAR_BIT <= W::bits * W::levels)
+			return;
+		const W::time_type far = 3UL << (W::bits * W::levels);
+		W x(far - 10);
+		MyDeque<int> e;
+		x.schedule(far + 5, 2);
+		x.schedule(far * 2, 3);
+		x.schedule(far - 5, 1);
+		CPPUNIT_ASSERT(x.advance(far + 5, e) == 2);
+		CPPUNIT_ASSERT(x.advance(far * 2 - 1, e) == 0);
+		CPPUNIT_ASSERT(x.advance(far * 2, e) == 1);
+		const int a[] = {1, 2, 3};
+		CPPUNIT_ASSERT(std::equal(a, a + 3, e.begin()));
+	}
+
+	// ------
+	// cancel
+	void test_cancel_1 () {
+		W x;
+		MyDeque<int> e;
+		const W::handle a = x.schedule(10, 1);
+		const W::handle b = x.schedule(1000, 2);
+		x.schedule(10, 3);
+		CPPUNIT_ASSERT(x.cancel(a));
+		CPPUNIT_ASSERT(!x.cancel(a));
+		CPPUNIT_ASSERT(!x.cancel(W::handle()));
+		CPPUNIT_ASSERT(x.size() == 2);
+		const W::handle c = x.schedule(20, 4);
+		CPPUNIT_ASSERT(!x.cancel(a));
+		CPPUNIT_ASSERT(x.advance(500, e) == 2);
+		CPPUNIT_ASSERT(!x.cancel(c));
+		CPPUNIT_ASSERT(x.cancel(b));
+		CPPUNIT_ASSERT(x.advance(2000, e) == 0);
+		CPPUNIT_ASSERT(e.size() == 2);
+		CPPUNIT_ASSERT(e[0] == 3 && e[1] == 4);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestTimerWheel);
+	CPPUNIT_TEST(test_advance_1);
+	CPPUNIT_TEST(test_advance_2);
+	CPPUNIT_TEST(test_cascade_1);
+	CPPUNIT_TEST(test_cascade_2);
+	CPPUNIT_TEST(test_overflow_1);
+	CPPUNIT_TEST(test_cancel_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#if __cplusplus >= 201703L
+// -------
+// Thrower
+struct Thrower {
+	static int budget;	// copies left before one throws, negative for no limit
+
+	int v;
+
+	Thrower (int v = 0) :
+		v(v) {}
+
+	Thrower (const Thrower& that) :
+		v(that.v) {
+		if (budget == 0)
+			throw std::invalid_argument("Thrower");
+		if (budget > 0)
+			--budget;}
+
+	Thrower& operator = (const Thrower&) = default;};
+
+int Thrower::budget = -1;
+
+// ---------------
+// TestColumnDeque
+struct TestColumnDeque : CppUnit::TestFixture {
+	typedef std::tuple<long, double, int, unsigned char> tick;
+
+	// ---------
+	// push_back
+	void test_push_back_1 () {
+		MyColumnDeque<tick> x;
+		for (int i = 0; i < 100; ++i)
+			x.push_back(tick(1000 + i, i * 0.5, i * 2, (unsigned char)i));
+		CPPUNIT_ASSERT(x.size() == 100);
+		CPPUNIT_ASSERT(std::get<0>(tick(x.front())) == 1000);
+		CPPUNIT_ASSERT(std::get<2>(tick(x.back())) == 198);
+		for (int i = 0; i < 100; ++i) {
+			CPPUNIT_ASSERT(x.get<0>(i) == 1000 + i);
+			CPPUNIT_ASSERT(x.get<1>(i) == i * 0.5);
+			CPPUNIT_ASSERT(x[i] == tick(1000 + i, i * 0.5, i * 2, (unsigned char)i));}
+	}
+
+	void test_push_back_2 () {
+		MyColumnDeque< std::array<int, 3> > x;
+		x.push_back(std::array<int, 3>{{1, 2, 3}});
+		x.push_front(std::array<int, 3>{{4, 5, 6}});
+		CPPUNIT_ASSERT(x.size() == 2);
+		CPPUNIT_ASSERT((x[0] == std::array<int, 3>{{4, 5, 6}}));
+		CPPUNIT_ASSERT(x.get<2>(1) == 3);
+	}
+
+	// --------
+	// push_pop
+	void test_push_pop_1 () {
+		typedef std::pair<int, char> record;
+		std::srand(5);
+		std::deque<record> d;
+		MyColumnDeque<record> x;
+		for (int i = 0; i < 5000; ++i) {
+			const record v(std::rand() % 1000, (char)('a' + std::rand() % 26));
+			switch (std::rand() % 4) {
+				case 0:
+					d.push_back(v);
+					x.push_back(v);
+					break;
+				case 1:
+					d.push_front(v);
+					x.push_front(v);
+					break;
+				case 2:
+					if (!d.empty()) {
+						d.pop_back();
+						x.pop_back();}
+					break;
+				default:
+					if (!d.empty()) {
+						d.pop_front();
+						x.pop_front();}}
+			CPPUNIT_ASSERT(x.size() == d.size());
+			if (!d.empty()) {
+				CPPUNIT_ASSERT(x.front() == d.front());
+				CPPUNIT_ASSERT(x.back() == d.back());}}
+		const MyColumnDeque<record>& y = x;
+		CPPUNIT_ASSERT(std::equal(d.begin(), d.end(), y.begin()));
+	}
+
+	// -----
+	// proxy
+	void test_proxy_1 () {
+		MyColumnDeque<tick> x;
+		for (int i = 0; i < 3; ++i)
+			x.push_back(tick(i, i, i, i));
+		x[0] = tick(7, 7.5, 7, 7);
+		x[2] = x[0];
+		CPPUNIT_ASSERT(x[2] == tick(7, 7.5, 7, 7));
+		x[1].get<3>() = 9;
+		CPPUNIT_ASSERT(x.get<3>(1) == 9);
+		swap(x[0], x[1]);
+		CPPUNIT_ASSERT(x[0] == tick(1, 1, 1, 9));
+		CPPUNIT_ASSERT(x[1] == tick(7, 7.5, 7, 7));
+		*(x.begin() + 2) = tick(3, 3, 3, 3);
+		CPPUNIT_ASSERT(x.at(2) == tick(3, 3, 3, 3));
+		try {
+			x.at(3);
+			CPPUNIT_ASSERT(false);}
+		catch (const std::out_of_range&) {}
+	}
+
+	// ------
+	// column
+	void test_column_1 () {
+		MyColumnDeque<tick> x;
+		for (int i = 0; i < 1000; ++i)
+			if (i % 2)
+				x.push_back(tick(i, 0.0, i, 0));
+			else
+				x.push_front(tick(i, 0.0, i, 0));
+		MySpan<long> c = x.column<0>();
+		CPPUNIT_ASSERT(c.size() == 1000);
+		long s = 0;
+		for (std::size_t i = 0; i < c.size(); ++i)
+			s += c.data()[i];
+		CPPUNIT_ASSERT(s == 999 * 1000 / 2);
+		CPPUNIT_ASSERT(c[0] == 998);
+		CPPUNIT_ASSERT(c[999] == 999);
+		for (long& v : c)
+			v *= 2;
+		CPPUNIT_ASSERT(x.get<0>(999) == 1998);
+		const MyColumnDeque<tick>& y = x;
+		MySpan<const int> d = y.column<2>();
+		CPPUNIT_ASSERT(std::equal(d.begin(), d.end(), x.column<2>().begin()));
+	}
+
+	void test_column_2 () {
+		// a bool field is an ordinary MyDeque<bool> column, with a data()
+		typedef std::tuple<long, double, int, bool> quote;
+		MyColumnDeque<quote> x;
+		for (int i = 0; i < 300; ++i)
+			x.push_back(quote(i, i * 0.25, i, i % 3 == 0));
+		MySpan<bool> f = x.column<3>();
+		CPPUNIT_ASSERT(f.size() == 300);
+		CPPUNIT_ASSERT(std::count(f.begin(), f.end(), true) == 100);
+		f[1] = true;
+		CPPUNIT_ASSERT(x.get<3>(1));
+		x.get<3>(0) = false;
+		CPPUNIT_ASSERT(!f[0]);
+		const MyColumnDeque<quote>& y = x;
+		CPPUNIT_ASSERT(y.get<3>(3));
+		CPPUNIT_ASSERT(y.column<3>().data() == &x.get<3>(0));
+		CPPUNIT_ASSERT(y[6] == quote(6, 1.5, 6, true));
+	}
+
+	// ---------
+	// exception
+	void test_exception_1 () {
+		MyColumnDeque< std::tuple<int, Thrower> > x;
+		x.push_back(std::make_tuple(1, Thrower(1)));
+		Thrower::budget = 0;
+		try {
+			x.push_front(std::make_tuple(2, Thrower(2)));
+			CPPUNIT_ASSERT(false);}
+		catch (const std::invalid_argument&) {}
+		Thrower::budget = -1;
+		CPPUNIT_ASSERT(x.size() == 1);
+		CPPUNIT_ASSERT(x.column<0>().size() == 1);
+		CPPUNIT_ASSERT(x.get<0>(0) == 1);
+	}
+
+	// -------
+	// compare
+	void test_compare_1 () {
+		MyColumnDeque< std::pair<int, int> > x;
+		x.push_back(std::make_pair(1, 2));
+		x.push_back(std::make_pair(3, 4));
+		MyColumnDeque< std::pair<int, int> > y(x);
+		CPPUNIT_ASSERT(x == y);
+		y.get<1>(1) = 5;
+		CPPUNIT_ASSERT(!(x == y));
+		CPPUNIT_ASSERT(x < y);
+		x.swap(y);
+		CPPUNIT_ASSERT(y < x);
+		x.clear();
+		CPPUNIT_ASSERT(x.empty());
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestColumnDeque);
+	CPPUNIT_TEST(test_push_back_1);
+	CPPUNIT_TEST(test_push_back_2);
+	CPPUNIT_TEST(test_push_pop_1);
+	CPPUNIT_TEST(test_proxy_1);
+	CPPUNIT_TEST(test_column_1);
+	CPPUNIT_TEST(test_column_2);
+	CPPUNIT_TEST(test_exception_1);
+	CPPUNIT_TEST(test_compare_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+#endif
+
+#if __cplusplus > 201703L
+// --------
+// produce
+MyTask produce (MyChannel<int>& c, int b, int e, bool close) {
+	for (int i = b; i < e; ++i)
+		co_await c.push(i);
+	if (close)
+		c.close();}
+
+// -------
+// consume
+MyTask consume (MyChannel<int>& c, MyDeque<int>& out) {
+	while (std::optional<int> v = co_await c.pop())
+		out.push_back(*v);}
+
+MyTask consume_batch (MyChannel<int>& c, MyDeque<int>& out, int& calls) {
+	for (;;) {
+		const MyChannel<int>::size_type n = co_await c.pop_batch(out, 4);
+		if (!n)
+			co_return;
+		++calls;}}
+
+// ----
+// send
+MyTask send (MyChannel<int>& c, int v, int& result) {
+	result = co_await c.push(v);}
+
+// -----------
+// TestChannel
+struct TestChannel : CppUnit::TestFixture {
+
+	// ---------
+	// push, pop
+	void test_push_pop_1 () {
+		MyExecutor ex;
+		MyChannel<int> c(ex, 4);
+		MyDeque<int> out;
+		ex.spawn(consume(c, out));
+		ex.spawn(produce(c, 0, 100, true));
+		ex.run();
+		CPPUNIT_ASSERT(out.size() == 100);
+		for (int i = 0; i < 100; ++i)
+			CPPUNIT_ASSERT(out[i] == i);
+		CPPUNIT_ASSERT(c.size() == 0);
+	}
+
+	void test_push_pop_2 () {
+		MyExecutor ex;
+		MyChannel<int> c(ex, 2);
+		int r1 = -1;
+		int r2 = -1;
+		int r3 = -1;
+		ex.spawn(send(c, 1, r1));
+		ex.spawn(send(c, 2, r2));
+		ex.spawn(send(c, 3, r3));
+		ex.run();
+		CPPUNIT_ASSERT(r1 == 1);
+		CPPUNIT_ASSERT(r2 == 1);
+		CPPUNIT_ASSERT(r3 == -1);
+		CPPUNIT_ASSERT(c.size() == 2);
+		CPPUNIT_ASSERT(*c.try_pop() == 1);
+		ex.run();
+		CPPUNIT_ASSERT(r3 == 1);
+		CPPUNIT_ASSERT(*c.try_pop() == 2);
+		CPPUNIT_ASSERT(*c.try_pop() == 3);
+		CPPUNIT_ASSERT(!c.try_pop());
+	}
+
+	void test_push_pop_3 () {
+		MyExecutor ex;
+		MyChannel<int> c(ex, 8);
+		MyDeque<int> out;
+		for (int i = 0; i < 1000; ++i)
+			ex.spawn(consume(c, out));
+		for (int i = 0; i < 1000; ++i)
+			ex.spawn(produce(c, 10 * i, 10 * i + 10, false));
+		ex.run();
+		CPPUNIT_ASSERT(out.size() == 10000);
+		c.close();
+		ex.run();
+		CPPUNIT_ASSERT(ex.empty());
+		long sum = 0;
+		for (int i = 0; i < 10000; ++i)
+			sum += out[i];
+		CPPUNIT_ASSERT(sum == 49995000L);
+	}
+
+	// -----
+	// close
+	void test_close_1 () {
+		MyExecutor ex;
+		MyChannel<int> c(ex);
+		int r = -1;
+		c.close();
+		ex.spawn(send(c, 1, r));
+		ex.run();
+		CPPUNIT_ASSERT(r == 0);
+		CPPUNIT_ASSERT(!c.try_push(2));
+	}
+
+	void test_close_2 () {
+		MyExecutor ex;
+		MyChannel<int> c(ex, 1);
+		int r = -1;
+		CPPUNIT_ASSERT(c.try_push(1));
+		CPPUNIT_ASSERT(!c.try_push(2));
+		ex.spawn(send(c, 2, r));
+		ex.run();
+		c.close();
+		ex.run();
+		CPPUNIT_ASSERT(r == 0);
+		MyDeque<int> out;
+		ex.spawn(consume(c, out));
+		ex.run();
+		CPPUNIT_ASSERT(out.size() == 1);
+		CPPUNIT_ASSERT(out[0] == 1);
+	}
+
+	// -----
+	// batch
+	void test_batch_1 () {
+		MyExecutor ex;
+		MyChannel<int> c(ex);
+		MyDeque<int> out;
+		int calls = 0;
+		for (int i = 0; i < 10; ++i)
+			c.try_push(i);
+		c.close();
+		ex.spawn(consume_batch(c, out, calls));
+		ex.run();
+		CPPUNIT_ASSERT(calls == 3);
+		CPPUNIT_ASSERT(out.size() == 10);
+		CPPUNIT_ASSERT(out[9] == 9);
+	}
+
+	void test_batch_2 () {
+		MyExecutor ex;
+		MyChannel<int> c(ex, 2);
+		MyDeque<int> out;
+		int calls = 0;
+		ex.spawn(consume_batch(c, out, calls));
+		ex.spawn(produce(c, 0, 20, true));
+		ex.run();
+		CPPUNIT_ASSERT(out.size() == 20);
+		for (int i = 0; i < 20; ++i)
+			CPPUNIT_ASSERT(out[i] == i);
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestChannel);
+	CPPUNIT_TEST(test_push_pop_1);
+	CPPUNIT_TEST(test_push_pop_2);
+	CPPUNIT_TEST(test_push_pop_3);
+	CPPUNIT_TEST(test_close_1);
+	CPPUNIT_TEST(test_close_2);
+	CPPUNIT_TEST(test_batch_1);
+	CPPUNIT_TEST(test_batch_2);
+	CPPUNIT_TEST_SUITE_END();
+};
+#endif
+
 // ----
 // main
 int main () {
@@ -1666,6 +4073,28 @@ int main () {
 	CppUnit::TextTestRunner tr;
 	//tr.addTest(TestDeque<   deque<int> >::suite() );
 	tr.addTest(TestDeque< MyDeque<int> >::suite() );
+	tr.addTest(TestDeque< MyGapDeque<int> >::suite() );
+	tr.addTest(TestGapDeque::suite() );
+	tr.addTest(TestComplexity::suite() );
+	tr.addTest(TestGapComplexity::suite() );
+	tr.addTest(TestAssign::suite() );
+	tr.addTest(TestDeque< MyIncrementalDeque<int> >::suite() );
+	tr.addTest(TestIncrementalDeque::suite() );
+	tr.addTest(TestWindow::suite() );
+	tr.addTest(TestCompressedDeque::suite() );
+	tr.addTest(TestBitDeque::suite() );
+	tr.addTest(TestSharedDeque::suite() );
+#ifdef __linux__
+	tr.addTest(TestMapping::suite() );
+#endif
+	tr.addTest(TestSnapshot::suite() );
+	tr.addTest(TestTimerWheel::suite() );
+#if __cplusplus >= 201703L
+	tr.addTest(TestColumnDeque::suite() );
+#endif
+#if __cplusplus > 201703L
+	tr.addTest(TestChannel::suite() );
+#endif
 	tr.run();
 
 	cout << "Done." << endl;
@@ -0,0 +1,188 @@
+// -------------
+// TestTrace.c++
+// -------------
+/*
+To test the trace recorder:
+	% g++ -ansi -pedantic -lcppunit -ldl -Wall -DDEQUE_TRACE TestTrace.c++ -o TestTrace.c++.app
+	% valgrind TestTrace.c++.app >& TestTrace.out
+
+MyTrace can only record a MyDeque built with its hooks, so these tests
+are their own program, compiled with -DDEQUE_TRACE, and TestDeque.c++
+tests the MyDeque everyone else gets.
+*/
+
+#ifndef DEQUE_TRACE
+#error TestTrace.c++ must be compiled with -DDEQUE_TRACE
+#endif
+
+// --------
+// includes
+#include <cstdio>    // remove
+#include <deque>	 // deque
+#include <fstream>   // ofstream
+#include <iostream>  // cout, endl, ios_base
+#include <sstream>   // ostringstream
+#include <string>	// string
+#include <vector>	// vector
+
+#include <unistd.h>   // getpid
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h"			 // TestFixture
+#include "cppunit/TestSuite.h"			   // TestSuite
+#include "cppunit/TextTestRunner.h"		  // TestRunner
+
+#include "Deque.h"
+#include "GapDeque.h"
+#include "IncrementalDeque.h"
+#include "Trace.h"
+
+// ---------
+// temp_name
+/**
+ * Returns a file name no other test run is using
+ */
+std::string temp_name (const char* tag) {
+	std::ostringstream out;
+	out << "/tmp/TestTrace-" << getpid() << "-" << tag;
+	return out.str();}
+
+// ---------
+// TestTrace
+struct TestTrace : CppUnit::TestFixture {
+	typedef MyTrace::record record;
+
+	static bool is (const record& r, MyTrace::op o, unsigned long id, unsigned long arg = 0) {
+		return r.o == o && r.id == id && r.arg == arg;}
+
+	// ------
+	// record
+	void test_record_1 () {
+		const std::string name = temp_name("record.trace");
+		std::vector<record> rs;
+		CPPUNIT_ASSERT(MyTrace::start(name.c_str()));
+		CPPUNIT_ASSERT(MyTrace::active());
+		{
+		MyDeque<int> x(3);
+		x.push_back(1);
+		x.push_front(2);
+		CPPUNIT_ASSERT(x[4] == 1);
+		x.insert(x.begin() + 1, 5);
+		x.erase(x.begin() + 3);
+		x.pop_back();
+		x.pop_front();
+		x.resize(200);
+		x.clear();
+		}
+		CPPUNIT_ASSERT(MyTrace::stop() == 11);
+		CPPUNIT_ASSERT(!MyTrace::active());
+		CPPUNIT_ASSERT(MyTrace::read(name.c_str(), rs));
+		CPPUNIT_ASSERT(rs.size() == 11);
+		CPPUNIT_ASSERT(is(rs[0], MyTrace::create, 0, 3));
+		CPPUNIT_ASSERT(is(rs[1], MyTrace::push_back, 0));
+		CPPUNIT_ASSERT(is(rs[2], MyTrace::push_front, 0));
+		CPPUNIT_ASSERT(is(rs[3], MyTrace::index, 0, 4));
+		CPPUNIT_ASSERT(is(rs[4], MyTrace::insert, 0, 1));
+		CPPUNIT_ASSERT(is(rs[5], MyTrace::erase, 0, 3));
+		CPPUNIT_ASSERT(is(rs[6], MyTrace::pop_back, 0));
+		CPPUNIT_ASSERT(is(rs[7], MyTrace::pop_front, 0));
+		CPPUNIT_ASSERT(is(rs[8], MyTrace::resize, 0, 200));
+		CPPUNIT_ASSERT(is(rs[9], MyTrace::clear, 0));
+		CPPUNIT_ASSERT(is(rs[10], MyTrace::destroy, 0));
+		std::remove(name.c_str());
+	}
+
+	void test_record_2 () {
+		const std::string name = temp_name("pairs.trace");
+		std::vector<record> rs;
+		MyDeque<int> x(2, 7);
+		CPPUNIT_ASSERT(MyTrace::start(name.c_str()));
+		{
+		MyDeque<int> y(x);
+		y.push_back(8);
+		x = y;
+		y.swap(x);
+		}
+		MyTrace::stop();
+		CPPUNIT_ASSERT(MyTrace::read(name.c_str(), rs));
+		CPPUNIT_ASSERT(rs.size() == 6);
+		CPPUNIT_ASSERT(is(rs[0], MyTrace::create, 0, 2));
+		CPPUNIT_ASSERT(is(rs[1], MyTrace::copy, 1, 0));
+		CPPUNIT_ASSERT(is(rs[2], MyTrace::push_back, 1));
+		CPPUNIT_ASSERT(is(rs[3], MyTrace::copy_assign, 0, 1));
+		CPPUNIT_ASSERT(is(rs[4], MyTrace::swap, 1, 0));
+		CPPUNIT_ASSERT(is(rs[5], MyTrace::destroy, 1));
+		std::remove(name.c_str());
+	}
+
+	// ----
+	// read
+	void test_read_1 () {
+		const std::string name = temp_name("bad.trace");
+		std::vector<record> rs;
+		CPPUNIT_ASSERT(!MyTrace::read(name.c_str(), rs));
+		{
+		std::ofstream out(name.c_str(), std::ios::binary);
+		out << "MYDQTRC1" << static_cast<char>(MyTrace::index) << static_cast<char>(0);
+		}
+		CPPUNIT_ASSERT(!MyTrace::read(name.c_str(), rs));
+		std::remove(name.c_str());
+	}
+
+	// ------
+	// replay
+	void test_replay_1 () {
+		const std::string name = temp_name("replay.trace");
+		std::vector<record> rs;
+		long sum = 0;
+		CPPUNIT_ASSERT(MyTrace::start(name.c_str()));
+		{
+		MyDeque<int> x;
+		for (int i = 0; i != 1000; ++i) {
+			x.push_back(i);
+			if (i % 3 == 0)
+				x.push_front(-i);
+			if (i % 5 == 0)
+				x.pop_front();
+			sum += x[x.size() / 2] + x.front() + x.back();}
+		MyDeque<int> y(x.begin(), x.begin() + 100);
+		y.insert(y.begin() + 50, 0);
+		y.erase(y.begin() + 10);
+		x = y;
+		x.resize(10);
+		for (int i = 0; i != 10; ++i)
+			sum += x.at(i);
+		}
+		MyTrace::stop();
+		CPPUNIT_ASSERT(MyTrace::read(name.c_str(), rs));
+		const long a = MyTrace::replay< MyDeque<int> >(rs);
+		CPPUNIT_ASSERT(a == MyTrace::replay< std::deque<int> >(rs));
+		CPPUNIT_ASSERT(a == MyTrace::replay< MyGapDeque<int> >(rs));
+		CPPUNIT_ASSERT(a == MyTrace::replay< MyIncrementalDeque<int> >(rs));
+		std::remove(name.c_str());
+	}
+
+	// -----
+	// suite
+	CPPUNIT_TEST_SUITE(TestTrace);
+	CPPUNIT_TEST(test_record_1);
+	CPPUNIT_TEST(test_record_2);
+	CPPUNIT_TEST(test_read_1);
+	CPPUNIT_TEST(test_replay_1);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+// ----
+// main
+int main () {
+	using namespace std;
+	ios_base::sync_with_stdio(false);		// turn off synchronization with C I/O
+	cout << "TestTrace.c++" << endl << endl;
+
+	CppUnit::TextTestRunner tr;
+	tr.addTest(TestTrace::suite() );
+	tr.run();
+
+	cout << "Done." << endl;
+	return 0;
+}
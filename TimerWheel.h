@@ -0,0 +1,268 @@
+// ------------
+// TimerWheel.h
+// ------------
+
+#ifndef TimerWheel_h
+#define TimerWheel_h
+
+// --------
+// includes
+#include <cassert>		// assert
+#include <climits>		// CHAR_BIT
+#include <cstddef>		// size_t
+
+#include "Deque.h"		// MyDeque
+
+// ------------
+// MyTimerWheel
+/**
+ * A hierarchical timing wheel: levels wheels of slots buckets each, the
+ * buckets being MyDeques of timers
+ * A timer due at tick d goes in the level of the highest byte in which d
+ * differs from now, at the slot of d's byte there; one due further out
+ * than the top level reaches waits in an overflow bucket. As now crosses
+ * into a slot's range, the slot is cascaded: its timers are placed again
+ * and so move down a level. Level 0's slot for now is then drained with
+ * pop_front, in the order its timers were placed.
+ * Scheduling and cancelling are O(1). A cancelled timer is only marked,
+ * by bumping its generation; its entry stays in its bucket and is
+ * dropped when the bucket is drained or cascaded. advance skips at once
+ * over ticks in which no bucket can be drained or cascaded, so sparse
+ * timers cost per timer, not per tick.
+ */
+template <typename T>
+class MyTimerWheel {
+	public:
+		// --------
+		// typedefs
+		typedef T				value_type;
+		typedef std::size_t		size_type;
+		typedef unsigned long	time_type;
+
+		enum {bits = 8, slots = 1 << bits, levels = 4};
+
+		// ------
+		// handle
+		/**
+		 * Names one scheduled timer; it goes stale once the timer fires or
+		 * is cancelled
+		 */
+		class handle {
+			friend class MyTimerWheel;
+
+			private:
+				size_type _index;
+				unsigned long _generation;
+
+				handle (size_type i, unsigned long g) :
+					_index(i), _generation(g) {}
+
+			public:
+				/**
+				 * Returns a handle to no timer
+				 */
+				handle () :
+					_index(size_type(-1)), _generation(0) {}};
+
+	private:
+		// -----
+		// timer
+		struct timer {
+			time_type deadline;
+			unsigned long generation;	// bumped when the timer fires or is cancelled
+			value_type value;};
+
+		// -----
+		// entry
+		struct entry {
+			size_type index;
+			unsigned long generation;};
+
+	private:
+		// ----
+		// data
+		MyDeque<timer> _timers;			// by handle index
+		MyDeque<size_type> _free;		// indexes of _timers to reuse
+		MyDeque<entry> _wheel[levels][slots];
+		MyDeque<entry> _overflow;
+		size_type _count[levels + 1];	// entries per level, the overflow's last
+		time_type _now;
+		size_type _size;
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return _size + _free.size() == _timers.size() && _count[levels] == _overflow.size();}
+
+		// ----
+		// live
+		bool live (const entry& e) const {
+			return _timers[e.index].generation == e.generation;}
+
+		// -----
+		// place
+		/**
+		 * Puts e, which is due at d > now, in its bucket
+		 */
+		void place (const entry& e, time_type d) {
+			const time_type x = d ^ _now;
+			int l = 0;
+			while (l + 1 != levels && (x >> (bits * (l + 1))))
+				++l;
+			if (bits * levels < sizeof(time_type) * CHAR_BIT && (x >> (bits * levels))) {
+				_overflow.push_back(e);
+				++_count[levels];}
+			else {
+				_wheel[l][(d >> (bits * l)) & (slots - 1)].push_back(e);
+				++_count[l];}}
+
+		// -------
+		// cascade
+		/**
+		 * Places b's live timers again, emptying b, which is on level l
+		 */
+		void cascade (MyDeque<entry>& b, int l) {
+			_count[l] -= b.size();
+			for (size_type n = b.size(); n; --n) {
+				const entry e = b.front();
+				b.pop_front();
+				if (live(e))
+					place(e, _timers[e.index].deadline);}}
+
+		// -------
+		// release
+		void release (size_type i) {
+			++_timers[i].generation;
+			_free.push_back(i);
+			--_size;}
+
+		// ----
+		// tick
+		/**
+		 * Moves now on by one tick, appending the timers due then to expired
+		 * Returns how many there were
+		 */
+		size_type tick (MyDeque<value_type>& expired) {
+			++_now;
+			if (bits * levels < sizeof(time_type) * CHAR_BIT &&
+					!(_now & ((time_type(1) << (bits * levels)) - 1)))
+				cascade(_overflow, levels);
+			for (int l = levels - 1; l; --l)
+				if (!(_now & ((time_type(1) << (bits * l)) - 1)))
+					cascade(_wheel[l][(_now >> (bits * l)) & (slots - 1)], l);
+			MyDeque<entry>& b = _wheel[0][_now & (slots - 1)];
+			_count[0] -= b.size();
+			size_type n = 0;
+			while (!b.empty()) {
+				const entry e = b.front();
+				b.pop_front();
+				if (live(e)) {
+					expired.push_back(_timers[e.index].value);
+					release(e.index);
+					++n;}}
+			return n;}
+
+	public:
+		// -----------
+		// constructor
+		/**
+		 * Returns a wheel with no timers whose clock reads now
+		 */
+		explicit MyTimerWheel (time_type now = 0) :
+				_now(now), _size(0) {
+			for (int l = 0; l != levels + 1; ++l)
+				_count[l] = 0;
+			assert(valid());}
+
+		// Default copy, destructor, and copy assignment.
+
+		// -------
+		// advance
+		/**
+		 * Moves the clock to now, appending the values of the timers due by
+		 * then to expired, earliest first
+		 * Returns how many timers fired
+		 */
+		size_type advance (time_type now, MyDeque<value_type>& expired) {
+			size_type n = 0;
+			while (_now < now) {
+				if (!_size) {
+					// any entries left are cancelled ones
+					_now = now;
+					break;}
+				int l = 0;
+				while (!_count[l])
+					++l;
+				if (l) {
+					// nothing happens before the next tick that cascades level l
+					const time_type mask = (time_type(1) << (bits * l)) - 1;
+					if (now - _now <= mask - (_now & mask)) {
+						_now = now;
+						break;}
+					_now |= mask;}
+				n += tick(expired);}
+			assert(valid());
+			return n;}
+
+		// ------
+		// cancel
+		/**
+		 * Stops the timer h names from firing
+		 * Returns false if it already fired or was cancelled
+		 */
+		bool cancel (const handle& h) {
+			if (h._index >= _timers.size() || _timers[h._index].generation != h._generation)
+				return false;
+			release(h._index);
+			assert(valid());
+			return true;}
+
+		// -----
+		// empty
+		bool empty () const {
+			return !size();}
+
+		// ---
+		// now
+		/**
+		 * Returns the tick the clock reads
+		 */
+		time_type now () const {
+			return _now;}
+
+		// --------
+		// schedule
+		/**
+		 * Sets a timer with value v to fire at tick d, or on the next tick
+		 * if d is not in the future
+		 * Returns the timer's handle
+		 */
+		handle schedule (time_type d, const value_type& v) {
+			if (d <= _now)
+				d = _now + 1;
+			size_type i;
+			if (_free.empty()) {
+				const timer t = {d, 0, v};
+				_timers.push_back(t);
+				i = _timers.size() - 1;}
+			else {
+				i = _free.back();
+				_free.pop_back();
+				_timers[i].deadline = d;
+				_timers[i].value = v;}
+			const entry e = {i, _timers[i].generation};
+			place(e, d);
+			++_size;
+			assert(valid());
+			return handle(i, e.generation);}
+
+		// ----
+		// size
+		/**
+		 * Returns the number of timers waiting to fire
+		 */
+		size_type size () const {
+			return _size;}};
+
+#endif // TimerWheel_h
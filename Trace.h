@@ -0,0 +1,314 @@
+// -------
+// Trace.h
+// -------
+
+#ifndef Trace_h
+#define Trace_h
+
+// --------
+// includes
+#include <cassert>		// assert
+#include <cstdio>		// EOF
+#include <fstream>		// ifstream, ofstream
+#include <istream>		// istream
+#include <map>			// map
+#include <ostream>		// ostream
+#include <string>		// string
+#include <vector>		// vector
+
+// -------
+// MyTrace
+/**
+ * Records deque operations to a compact binary file and replays them
+ * MyDeque reports its operations here when Deque.h is compiled with
+ * -DDEQUE_TRACE; recording then runs between start() and stop(). Only
+ * the outermost operation is recorded: what push_back or operator= do
+ * internally is reproduced by replaying them. Each deque is named by a
+ * number in order of first appearance, and one that existed before
+ * start() is introduced with a create of its size then.
+ * The file is the 8 bytes "MYDQTRC1", then per record the op as one
+ * byte, the deque number as a varint, and for ops that take one, the
+ * argument as a varint: a size, an index, or another deque's number.
+ * Recording is not thread-safe.
+ */
+class MyTrace {
+	public:
+		// --
+		// op
+		enum op {
+			create,			// arg: size
+			copy,			// arg: deque copied
+			destroy,
+			push_back,
+			push_front,
+			pop_back,
+			pop_front,
+			index,			// arg: index, for operator[], at, front and back
+			insert,			// arg: index
+			erase,			// arg: index
+			resize,			// arg: size
+			clear,
+			assign,			// arg: size afterwards
+			copy_assign,	// arg: deque copied
+			swap,			// arg: other deque
+			ops};
+
+		// ------
+		// record
+		struct record {
+			op				o;
+			unsigned long	id;
+			unsigned long	arg;};
+
+	private:
+		// -----
+		// state
+		struct state {
+			std::ofstream						out;
+			std::map<const void*, unsigned long>	ids;
+			unsigned long						next;
+			int									depth;	// traced operations in progress
+			unsigned long						records;
+
+			state () :
+				next(0), depth(0), records(0) {}};
+
+		static state& get () {
+			static state s;
+			return s;}
+
+		// -------
+		// has_arg
+		static bool has_arg (op o) {
+			return !(o == destroy || o == push_back || o == push_front ||
+				o == pop_back || o == pop_front || o == clear);}
+
+		// ---
+		// put
+		static void put (unsigned long n) {
+			std::ofstream& out = get().out;
+			for (; n >= 0x80; n >>= 7)
+				out.put(static_cast<char>((n & 0x7F) | 0x80));
+			out.put(static_cast<char>(n));}
+
+		// ---
+		// id
+		/**
+		 * Returns d's number, introducing d with a create of size s if it is new
+		 */
+		static unsigned long id (const void* d, unsigned long s, bool known) {
+			state& t = get();
+			std::map<const void*, unsigned long>::iterator p = t.ids.find(d);
+			if (p != t.ids.end())
+				return p->second;
+			const unsigned long n = t.next++;
+			t.ids[d] = n;
+			if (!known)
+				write(create, n, s);
+			return n;}
+
+		// -----
+		// write
+		static void write (op o, unsigned long n, unsigned long arg) {
+			get().out.put(static_cast<char>(o));
+			put(n);
+			if (has_arg(o))
+				put(arg);
+			++get().records;}
+
+	public:
+		// -----
+		// scope
+		/**
+		 * Marks one deque operation; it is recorded when the scope ends, if
+		 * no other traced operation was already in progress when it began
+		 */
+		template <typename D>
+		class scope {
+			private:
+				const D* _d;
+				op _o;
+				unsigned long _arg;
+				const D* _other;
+				unsigned long _size;	// d's size on entry, in case d is new to the trace
+				unsigned long _other_size;
+				bool _outer;
+
+				scope (const scope&);
+				scope& operator = (const scope&);
+
+			public:
+				scope (const D* d, op o, unsigned long arg) :
+						_d(d), _o(o), _arg(arg), _other(0), _size(0), _other_size(0),
+						_outer(!get().depth++ && active()) {
+					if (_outer && o != create)
+						_size = d->size();}
+
+				scope (const D* d, op o, const D* other, bool constructed) :
+						_d(d), _o(o), _arg(0), _other(other), _size(0), _other_size(0),
+						_outer(!get().depth++ && active()) {
+					if (_outer) {
+						if (constructed)
+							_size = d->size();
+						_other_size = other->size();}}
+
+				~scope () {
+					--get().depth;
+					if (!_outer || !active())
+						return;
+					if (_other)
+						_arg = id(_other, _other_size, false);
+					const unsigned long n = id(_d, _size, _o == create || _o == copy);
+					write(_o, n, _arg);
+					if (_o == destroy)
+						get().ids.erase(_d);}
+
+				/**
+				 * Replaces the argument, for ops that only know it at the end
+				 */
+				void arg (unsigned long n) {
+					_arg = n;}};
+
+	public:
+		// ------
+		// active
+		/**
+		 * Returns whether a trace is being recorded
+		 */
+		static bool active () {
+			return get().out.is_open();}
+
+		// -----
+		// start
+		/**
+		 * Starts recording to the file path, replacing it
+		 * Returns false if it cannot be opened
+		 */
+		static bool start (const char* path) {
+			state& t = get();
+			assert(!active());
+			t.out.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!t.out)
+				return false;
+			t.out.write("MYDQTRC1", 8);
+			t.ids.clear();
+			t.next = 0;
+			t.records = 0;
+			return true;}
+
+		// ----
+		// stop
+		/**
+		 * Stops recording
+		 * Returns the number of records written
+		 */
+		static unsigned long stop () {
+			state& t = get();
+			t.out.close();
+			t.ids.clear();
+			return t.records;}
+
+		// ----
+		// read
+		/**
+		 * Reads the trace in path into rs
+		 * Returns false if the file is missing, not a trace, or truncated
+		 */
+		static bool read (const char* path, std::vector<record>& rs) {
+			std::ifstream in(path, std::ios::in | std::ios::binary);
+			char h[8];
+			if (!in.read(h, 8) || std::string(h, 8) != "MYDQTRC1")
+				return false;
+			int c;
+			while ((c = in.get()) != EOF) {
+				record r;
+				if (c >= ops)
+					return false;
+				r.o = static_cast<op>(c);
+				r.arg = 0;
+				if (!get(in, r.id) || (has_arg(r.o) && !get(in, r.arg)))
+					return false;
+				rs.push_back(r);}
+			return true;}
+
+		// ------
+		// replay
+		/**
+		 * Runs the operations in rs on deques of type C, pushing increasing
+		 * ints, and returns the sum of the elements read so the work is kept
+		 */
+		template <typename C>
+		static long replay (const std::vector<record>& rs) {
+			std::map<unsigned long, C*> m;
+			long sink = 0;
+			int v = 0;
+			for (typename std::vector<record>::const_iterator p = rs.begin(); p != rs.end(); ++p) {
+				C*& c = m[p->id];
+				switch (p->o) {
+					case create:
+						c = new C(p->arg);
+						break;
+					case copy:
+						c = new C(*m[p->arg]);
+						break;
+					case destroy:
+						delete c;
+						m.erase(p->id);
+						break;
+					case push_back:
+						c->push_back(v++);
+						break;
+					case push_front:
+						c->push_front(v++);
+						break;
+					case pop_back:
+						c->pop_back();
+						break;
+					case pop_front:
+						c->pop_front();
+						break;
+					case index:
+						sink += (*c)[p->arg];
+						break;
+					case insert:
+						c->insert(c->begin() + p->arg, v++);
+						break;
+					case erase:
+						c->erase(c->begin() + p->arg);
+						break;
+					case resize:
+						c->resize(p->arg);
+						break;
+					case clear:
+						c->clear();
+						break;
+					case assign:
+						c->clear();
+						c->resize(p->arg);
+						break;
+					case copy_assign:
+						*c = *m[p->arg];
+						break;
+					case swap:
+						c->swap(*m[p->arg]);
+						break;
+					default:
+						assert(false);}}
+			for (typename std::map<unsigned long, C*>::iterator p = m.begin(); p != m.end(); ++p)
+				delete p->second;
+			return sink;}
+
+	private:
+		// ---
+		// get
+		static bool get (std::istream& in, unsigned long& n) {
+			n = 0;
+			for (int s = 0; ; s += 7) {
+				const int c = in.get();
+				if (c == EOF)
+					return false;
+				n |= static_cast<unsigned long>(c & 0x7F) << s;
+				if (!(c & 0x80))
+					return true;}}};
+
+#endif // Trace_h
@@ -11,7 +11,8 @@
 #include <stdexcept> // out_of_range
 #include <utility>   // !=, <=, >, >=
 
-#include "Memory.h"  // my_destroy, my_uninitialized_copy, my_uninitialized_fill
+#include "Deque.h"   // destroy, uninitialized_copy, uninitialized_fill
+#include "Mapping.h" // MyMapping
 
 /*
 namespace std     {
@@ -38,12 +39,6 @@ inline bool operator >= (const T& lhs, const T& rhs) {
 */
 
 using namespace std::rel_ops;
-void printD(){
-	cerr << "contents: ";
-	for(int i = 0; i < d.size(); ++i)
-		cerr << d[i];
-	 cerr << endl;
-}
 
 template <typename T, typename A = std::allocator<T> >
 class my_vector {
@@ -54,14 +49,14 @@ class my_vector {
         typedef typename allocator_type::size_type       size_type;
         typedef typename allocator_type::difference_type difference_type;
 
-        typedef typename allocator_type::pointer         pointer;
-        typedef typename allocator_type::const_pointer   const_pointer;
+        typedef value_type*                              pointer;
+        typedef const value_type*                        const_pointer;
 
-        typedef typename allocator_type::reference       reference;
-        typedef typename allocator_type::const_reference const_reference;
+        typedef value_type&                              reference;
+        typedef const value_type&                        const_reference;
 
-        typedef typename allocator_type::pointer         iterator;
-        typedef typename allocator_type::const_pointer   const_iterator;
+        typedef pointer                                  iterator;
+        typedef const_pointer                            const_iterator;
 
     public:
         friend bool operator == (const my_vector& lhs, const my_vector& rhs) {
@@ -82,15 +77,15 @@ class my_vector {
 
     private:
         bool valid () const {
-            return (!_b && !_e && !_l) || (_b <= _e) && (_e <= _l);}
+            return (!_b && !_e && !_l) || ((_b <= _e) && (_e <= _l));}
 
         my_vector (const my_vector& that, size_type c) :
                 _a (that._a) {
             assert(c >= that.size());
-            _b = _a.allocate(c);
+            _b = MyMapping<T, A>::allocate(_a, c);
             _e = _b + that.size();
             _l = _b + c;
-            my_uninitialized_copy(_a, that.begin(), that.end(), begin());
+            uninitialized_copy(_a, that.begin(), that.end(), begin());
             assert(valid());}
 
     public:
@@ -101,22 +96,22 @@ class my_vector {
 
         explicit my_vector (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type()) :
                 _a (a) {
-            _b = _a.allocate(s);
+            _b = MyMapping<T, A>::allocate(_a, s);
             _e = _l = _b + s;
-            my_uninitialized_fill(_a, begin(), end(), v);
+            uninitialized_fill(_a, begin(), end(), v);
             assert(valid());}
 
         my_vector (const my_vector& that) :
                 _a (that._a) {
-            _b = _a.allocate(that.size());
+            _b = MyMapping<T, A>::allocate(_a, that.size());
             _e = _l = _b + that.size();
-            my_uninitialized_copy(_a, that.begin(), that.end(), begin());
+            uninitialized_copy(_a, that.begin(), that.end(), begin());
             assert(valid());}
 
         ~my_vector () {
             if (_b) {
                 clear();
-                _a.deallocate(_b, capacity());}
+                MyMapping<T, A>::deallocate(_a, _b, capacity());}
             assert(valid());}
 
         my_vector& operator = (const my_vector& that) {
@@ -129,11 +124,11 @@ class my_vector {
                 resize(that.size());}
             else if (that.size() <= capacity()) {
                 std::copy(that.begin(), that.begin() + size(), begin());
-                _e = my_uninitialized_copy(_a, that.begin() + size(), that.end(), end());}
+                _e = uninitialized_copy(_a, that.begin() + size(), that.end(), end());}
             else {
                 clear();
                 reserve(that.size());
-                _e = my_uninitialized_copy(_a, that.begin(), that.end(), begin());}
+                _e = uninitialized_copy(_a, that.begin(), that.end(), begin());}
             assert(valid());
             return *this;}
 
@@ -143,7 +138,7 @@ class my_vector {
         const_reference operator [] (size_type i) const {
             return const_cast<my_vector&>(*this)[i];}
 
-        reference at (size_type i) throw (std::out_of_range) {
+        reference at (size_type i) {
             if (i >= size())
                 throw std::out_of_range("vector::_M_range_check");
             return (*this)[i];}
@@ -198,7 +193,15 @@ class my_vector {
             assert(valid());}
 
         void reserve (size_type c) {
-            if (c > capacity()) {
+            if (c <= capacity())
+                return;
+            if (MyMapping<T, A>::mapped(c)) {
+                // remapped rather than copied, see MyMapping
+                const size_type s = size();
+                _b = MyMapping<T, A>::reallocate(_a, _b, capacity(), c);
+                _e = _b + s;
+                _l = _b + c;}
+            else {
                 my_vector x(*this, c);
                 swap(x);}
             assert(valid());}
@@ -207,9 +210,9 @@ class my_vector {
             if (s == size())
                 return;
             if (s < size())
-                _e = my_destroy(_a, begin() + s, end());
+                _e = destroy(_a, begin() + s, end());
             else if (s <= capacity())
-                _e = my_uninitialized_fill(_a, end(), begin() + s, v);
+                _e = uninitialized_fill(_a, end(), begin() + s, v);
             else {
                 reserve(std::max(2 * size(), s));
                 resize(s, v);}
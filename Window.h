@@ -0,0 +1,358 @@
+// --------
+// Window.h
+// --------
+
+#ifndef Window_h
+#define Window_h
+
+// --------
+// includes
+#include <cassert>		// assert
+#include <cstddef>		// size_t
+#include <functional>	// less, plus
+
+#include "Deque.h"		// MyDeque
+
+// -----------------
+// MyMonotonicWindow
+/**
+ * Tracks the extremum of a sliding window in amortized O(1) per update
+ * With Compare = std::less the window reports its minimum, with
+ * std::greater its maximum. Only the elements that can still become the
+ * extremum are kept as candidates; every element's stamp is kept so the
+ * window can expire by time as well as by count.
+ * Stamps must be pushed in nondecreasing order.
+ */
+template < typename T, typename Compare = std::less<T>, typename S = long >
+class MyMonotonicWindow {
+	public:
+		// --------
+		// typedefs
+		typedef T				value_type;
+		typedef S				stamp_type;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+
+	private:
+		// -----
+		// entry
+		struct entry {
+			size_type	seq;	// position in the stream
+			value_type	value;
+
+			entry (size_type s, const_reference v) :
+				seq(s), value(v) {}};
+
+	private:
+		// ----
+		// data
+		Compare _c;
+		MyDeque<entry> _q;			// candidates, strictly ordered by _c from the front
+		MyDeque<stamp_type> _stamps;	// stamp of every element in the window, oldest first
+		size_type _head;			// seq of the oldest element in the window
+		size_type _tail;			// seq of the next element pushed
+		size_type _limit;			// most elements kept, 0 for no limit
+		stamp_type _span;			// widest stamp range kept, 0 for no limit
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return (_head <= _tail) && (_q.size() <= size()) && (_stamps.size() == size()) &&
+				(_q.empty() == empty());}
+
+	public:
+		// -----------
+		// constructor
+		/**
+		 * Returns an empty window that keeps at most n elements (0 for no limit)
+		 * and drops elements more than span older than the newest (0 for no limit)
+		 */
+		explicit MyMonotonicWindow (size_type n = 0, stamp_type span = stamp_type(), const Compare& c = Compare()) :
+			_c(c), _head(0), _tail(0), _limit(n), _span(span) {
+			assert(valid());}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the window holds no elements
+		 */
+		bool empty () const {
+			return !size();}
+
+		// ------
+		// expire
+		/**
+		 * Removes every element stamped before t
+		 */
+		void expire (stamp_type t) {
+			while (!empty() && _stamps.front() < t)
+				pop();
+			assert(valid());}
+
+		// ---------
+		// keep_last
+		/**
+		 * Removes the oldest elements until at most n remain
+		 */
+		void keep_last (size_type n) {
+			while (size() > n)
+				pop();
+			assert(valid());}
+
+		// ---
+		// pop
+		/**
+		 * Removes the oldest element
+		 */
+		void pop () {
+			assert(!empty());
+			if (_q.front().seq == _head)
+				_q.pop_front();
+			_stamps.pop_front();
+			++_head;
+			assert(valid());}
+
+		// ----
+		// push
+		/**
+		 * Appends v stamped t, then evicts whatever the limits no longer allow
+		 */
+		void push (const_reference v, stamp_type t = stamp_type()) {
+			assert(empty() || !(t < _stamps.back()));
+			append(v, t);
+			evict();}
+
+		// ------
+		// ingest
+		/**
+		 * Appends every value in [b, e) stamped t, evicting once at the end
+		 */
+		template <typename II>
+		void ingest (II b, II e, stamp_type t = stamp_type()) {
+			assert(empty() || !(t < _stamps.back()));
+			while (b != e) {
+				append(*b, t);
+				++b;}
+			evict();}
+
+		// ----
+		// size
+		/**
+		 * Returns the number of elements in the window
+		 */
+		size_type size () const {
+			return _tail - _head;}
+
+		// -----
+		// value
+		/**
+		 * Returns the extremum of the window
+		 */
+		const_reference value () const {
+			assert(!empty());
+			return _q.front().value;}
+
+	private:
+		// ------
+		// append
+		void append (const_reference v, stamp_type t) {
+			while (!_q.empty() && !_c(_q.back().value, v))
+				_q.pop_back();
+			_q.push_back(entry(_tail, v));
+			_stamps.push_back(t);
+			++_tail;}
+
+		// -----
+		// evict
+		void evict () {
+			if (_limit)
+				keep_last(_limit);
+			if (!(_span == stamp_type()) && !empty())
+				expire(_stamps.back() - _span);
+			assert(valid());}};
+
+// -----------------
+// MyAggregateWindow
+/**
+ * Folds any associative operator over a sliding window in amortized O(1)
+ * per update, using two stacks on MyDeque: new elements land on the back
+ * stack under a running fold, and the front stack holds the oldest
+ * elements, each with the fold of itself and everything newer in that
+ * stack. When the front stack runs dry the back stack is flipped onto it.
+ * Op need not be commutative or invertible, only associative.
+ * Stamps must be pushed in nondecreasing order.
+ */
+template < typename T, typename Op = std::plus<T>, typename S = long >
+class MyAggregateWindow {
+	public:
+		// --------
+		// typedefs
+		typedef T				value_type;
+		typedef S				stamp_type;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+
+	private:
+		// -----
+		// entry
+		struct entry {
+			stamp_type	stamp;
+			value_type	value;
+			value_type	fold;	// front stack only: this value folded with everything newer below it
+
+			entry (stamp_type t, const_reference v, const_reference f) :
+				stamp(t), value(v), fold(f) {}};
+
+	private:
+		// ----
+		// data
+		Op _op;
+		MyDeque<entry> _out;	// front stack, oldest element at back()
+		MyDeque<entry> _in;	// back stack, newest element at back()
+		value_type _fold;	// fold of the back stack, meaningless when it is empty
+		size_type _limit;	// most elements kept, 0 for no limit
+		stamp_type _span;	// widest stamp range kept, 0 for no limit
+
+	private:
+		// -----
+		// valid
+		bool valid () const {
+			return empty() || !(newest() < oldest());}
+
+	public:
+		// -----------
+		// constructor
+		/**
+		 * Returns an empty window that keeps at most n elements (0 for no limit)
+		 * and drops elements more than span older than the newest (0 for no limit)
+		 */
+		explicit MyAggregateWindow (size_type n = 0, stamp_type span = stamp_type(), const Op& op = Op()) :
+			_op(op), _fold(), _limit(n), _span(span) {
+			assert(valid());}
+
+		// -----
+		// empty
+		/**
+		 * Returns whether the window holds no elements
+		 */
+		bool empty () const {
+			return _out.empty() && _in.empty();}
+
+		// ------
+		// expire
+		/**
+		 * Removes every element stamped before t
+		 */
+		void expire (stamp_type t) {
+			while (!empty() && oldest() < t)
+				pop();
+			assert(valid());}
+
+		// ---------
+		// keep_last
+		/**
+		 * Removes the oldest elements until at most n remain
+		 */
+		void keep_last (size_type n) {
+			while (size() > n)
+				pop();
+			assert(valid());}
+
+		// ---
+		// pop
+		/**
+		 * Removes the oldest element
+		 */
+		void pop () {
+			assert(!empty());
+			if (_out.empty())
+				flip();
+			_out.pop_back();
+			assert(valid());}
+
+		// ----
+		// push
+		/**
+		 * Appends v stamped t, then evicts whatever the limits no longer allow
+		 */
+		void push (const_reference v, stamp_type t = stamp_type()) {
+			append(v, t);
+			evict();}
+
+		// ------
+		// ingest
+		/**
+		 * Appends every value in [b, e) stamped t, evicting once at the end
+		 */
+		template <typename II>
+		void ingest (II b, II e, stamp_type t = stamp_type()) {
+			while (b != e) {
+				append(*b, t);
+				++b;}
+			evict();}
+
+		// ----
+		// size
+		/**
+		 * Returns the number of elements in the window
+		 */
+		size_type size () const {
+			return _out.size() + _in.size();}
+
+		// -----
+		// value
+		/**
+		 * Returns the fold of Op over the window, oldest element first
+		 */
+		value_type value () const {
+			assert(!empty());
+			if (_out.empty())
+				return _fold;
+			if (_in.empty())
+				return _out.back().fold;
+			return _op(_out.back().fold, _fold);}
+
+	private:
+		// ------
+		// append
+		void append (const_reference v, stamp_type t) {
+			assert(empty() || !(t < newest()));
+			_fold = _in.empty() ? v : _op(_fold, v);
+			_in.push_back(entry(t, v, v));}
+
+		// -----
+		// evict
+		void evict () {
+			if (_limit)
+				keep_last(_limit);
+			if (!(_span == stamp_type()) && !empty())
+				expire(newest() - _span);
+			assert(valid());}
+
+		// ----
+		// flip
+		/**
+		 * Moves the back stack onto the front stack, newest first, building the suffix folds
+		 */
+		void flip () {
+			assert(_out.empty());
+			while (!_in.empty()) {
+				const entry& x = _in.back();
+				if (_out.empty())
+					_out.push_back(entry(x.stamp, x.value, x.value));
+				else
+					_out.push_back(entry(x.stamp, x.value, _op(x.value, _out.back().fold)));
+				_in.pop_back();}}
+
+		// ------
+		// newest
+		stamp_type newest () const {
+			return _in.empty() ? _out.front().stamp : _in.back().stamp;}
+
+		// ------
+		// oldest
+		stamp_type oldest () const {
+			return _out.empty() ? _in.front().stamp : _out.back().stamp;}};
+
+#endif // Window_h
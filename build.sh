@@ -5,12 +5,39 @@ outFile="TestDeque.out"
 
 clear
 echo COMPILING $source and $unitFile...
-g++ -ansi -pedantic -ldl -Wall $unitFile -lcppunit -o $unitFile.app
+g++ -ansi -pedantic -ldl -Wall $unitFile -lcppunit -lpthread -lrt -o $unitFile.app
 	if ([ $? == 0 ]); then
 echo RUNNING UNIT TESTS...
 valgrind ./$unitFile.app >& $outFile
 	fi
 
+echo COMPILING $unitFile with C++20 coroutines and C++17 columns...
+g++ -std=c++20 -pedantic -ldl -Wall $unitFile -lcppunit -lpthread -lrt -o $unitFile.20.app
+	if ([ $? == 0 ]); then
+echo RUNNING C++20 UNIT TESTS...
+valgrind ./$unitFile.20.app >> $outFile 2>&1
+	fi
+
+echo COMPILING TestTrace.c++ with the trace hooks...
+g++ -ansi -pedantic -ldl -Wall -DDEQUE_TRACE TestTrace.c++ -lcppunit -o TestTrace.c++.app
+	if ([ $? == 0 ]); then
+echo RUNNING TRACE TESTS...
+valgrind ./TestTrace.c++.app >> $outFile 2>&1
+	fi
+
+
+echo COMPILING BenchWindow.c++...
+g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchWindow.c++ -o BenchWindow.c++.app
+
+echo COMPILING BenchGrowth.c++...
+g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchGrowth.c++ -o BenchGrowth.c++.app
+
+echo COMPILING BenchTimer.c++...
+g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchTimer.c++ -o BenchTimer.c++.app
+
+echo COMPILING Replay.c++ and its recorder...
+g++ -ansi -pedantic -Wall -O2 -DNDEBUG Replay.c++ -o Replay.c++.app
+g++ -ansi -pedantic -Wall -O2 -DNDEBUG -DDEQUE_TRACE Replay.c++ -o Record.app
 
 echo GENERATING COMMIT LOG...
 git log > Deque.log
@@ -23,7 +50,7 @@ echo RUNNING DOXYGEN...
 # GENERATE_LATEX         = NO
 doxygen Doxyfile
 
-zip Deque README.txt html/* Deque.h Deque.log TestDeque.c++ TestDeque.out
+zip Deque README.txt html/* Deque.h BitDeque.h GapDeque.h IncrementalDeque.h Window.h Channel.h CompressedDeque.h ColumnDeque.h SharedDeque.h Trace.h Mapping.h Snapshot.h SnapshotView.h TimerWheel.h BenchWindow.c++ BenchGrowth.c++ BenchTimer.c++ Replay.c++ Deque.log TestDeque.c++ TestTrace.c++ TestDeque.out
 
 turnin --submit inbleric cs378pj4 Deque.zip
 turnin --list   inbleric cs378pj4